@@ -7,6 +7,23 @@
 -- Input and output data are transferred as data streams using two Avalon-ST interfaces.
 -- For input Avalon-ST sink interface with 8-bit datapath and readyLatency 0 is used.
 -- Output 16-bit wide is transmitted trough Avalon-ST source interface 16-bit wide with readyLatency 0.
+-- With generic G_OUT_WIDTH set to 8 only the low byte of Y is transmitted (Y modulo 256), so the module
+-- can be chained in front of acc_scale: SGDMA -> acc_linear_function -> acc_scale -> SGDMA.
+--
+-- Operation is selected by mode register:
+-- 0 - Y=AX+B with signed X (result 16-bit wide, low byte of it with G_OUT_WIDTH 8),
+-- 1 - Y=AX+B with unsigned X (0..255 pixel), result saturated to unsigned 8-bit range [0,255],
+-- 2 - Y=LUT(X), 256-entry table loaded through LUT data register (gamma, threshold, curves...).
+-- In modes 1 and 2 result fits in 8 bits, so with G_OUT_WIDTH 8 nothing is lost and output
+-- bandwidth is equal to input bandwidth. Writing mode register resets LUT write index to 0, every
+-- write of LUT data register stores one table entry and moves index to the next one. LUT should be
+-- loaded while no data is streamed.
+--
+-- With generic G_LANES set to 2, 4 or 8 a whole beat of G_LANES pixels (SGDMA data width) is processed
+-- in each clock, every lane has its own multiplier (embedded 9x9 multiplier) and its own copy of LUT.
+-- First pixel of a beat is in the high order bits (firstSymbolInHighOrderBits), results keep the same
+-- order. Handshake FSM is the same as with one lane, startofpacket, endofpacket and empty are carried
+-- along with the data, so the last beat of a frame may hold less than G_LANES pixels.
 
 --Author: Dragomir El Mezeni
 --Institution/Company: University of Belgrade, School of Electrical Engineering
@@ -18,38 +35,57 @@ use IEEE.std_logic_1164.all;
 use IEEE.numeric_std.all;
 
 entity acc_linear_function is
+	generic (
+		G_OUT_WIDTH : natural := 16; -- width of one result, 16 (whole Y) or 8 (low byte of Y)
+		G_LANES : natural := 1; -- pixels processed in one beat, 1, 2, 4 or 8
+		G_IN_EMPTY_WIDTH : natural := 1; -- width of asi_in_empty, log2(G_LANES) (at least 1)
+		G_OUT_EMPTY_WIDTH : natural := 1 -- width of aso_out_empty, log2(G_LANES*G_OUT_WIDTH/8) (at least 1)
+	);
 	port (
 		reset                  : in  std_logic                     := '0';             --  reset.reset
-		avs_params_address     : in  std_logic                     := '0';             -- params.address
+		avs_params_address     : in  std_logic_vector(1 downto 0)  := (others => '0'); -- params.address
 		avs_params_read        : in  std_logic                     := '0';             --       .read
 		avs_params_readdata    : out std_logic_vector(7 downto 0);                     --       .readdata
 		avs_params_write       : in  std_logic                     := '0';             --       .write
 		avs_params_writedata   : in  std_logic_vector(7 downto 0)  := (others => '0'); --       .writedata
 		avs_params_waitrequest : out std_logic;                                        --       .waitrequest
 		clk                    : in  std_logic                     := '0';             --  clock.clk
-		asi_in_data            : in  std_logic_vector(7 downto 0)  := (others => '0'); --     in.data
+		asi_in_data            : in  std_logic_vector(8*G_LANES - 1 downto 0) := (others => '0'); --     in.data
 		asi_in_ready           : out std_logic;                                        --       .ready
 		asi_in_valid           : in  std_logic                     := '0';             --       .valid
 		asi_in_sop             : in  std_logic                     := '0';             --       .startofpacket
 		asi_in_eop             : in  std_logic                     := '0';             --       .endofpacket
-		aso_out_data           : out std_logic_vector(15 downto 0);                    --    out.data
+		asi_in_empty           : in  std_logic_vector(G_IN_EMPTY_WIDTH - 1 downto 0) := (others => '0'); -- .empty
+		aso_out_data           : out std_logic_vector(G_OUT_WIDTH*G_LANES - 1 downto 0); --    out.data
 		aso_out_ready          : in  std_logic                     := '0';             --       .ready
 		aso_out_valid          : out std_logic;                                        --       .valid
 		aso_out_sop            : out std_logic;                                        --       .startofpacket
 		aso_out_eop            : out std_logic;                                        --       .endofpacket
-		aso_out_empty          : out std_logic                                         --       .empty
+		aso_out_empty          : out std_logic_vector(G_OUT_EMPTY_WIDTH - 1 downto 0)  --       .empty
 	);
 end entity acc_linear_function;
 
 architecture rtl of acc_linear_function is
 	signal a_reg : std_logic_vector(7 downto 0);
 	signal b_reg : std_logic_vector(7 downto 0);
+	signal mode_reg : std_logic_vector(1 downto 0);
+	
+	constant A_ADDR : std_logic_vector(1 downto 0) := "00";
+	constant B_ADDR : std_logic_vector(1 downto 0) := "01";
+	constant MODE_ADDR : std_logic_vector(1 downto 0) := "10";
+	constant LUT_ADDR : std_logic_vector(1 downto 0) := "11";
 	
-	constant A_ADDR : std_logic := '0';
-	constant B_ADDR : std_logic := '1';
+	constant MODE_LINEAR : std_logic_vector(1 downto 0) := "00";
+	constant MODE_SATURATE : std_logic_vector(1 downto 0) := "01";
+	constant MODE_LUT : std_logic_vector(1 downto 0) := "10";
 	
 	signal a_strobe : std_logic;
 	signal b_strobe : std_logic;
+	signal mode_strobe : std_logic;
+	signal lut_strobe : std_logic;
+	
+	type lut_type is array (0 to 255) of std_logic_vector(7 downto 0);
+	signal lut_index : unsigned(7 downto 0);
 	
 	signal read_out_mux : std_logic_vector(7 downto 0);
 	
@@ -61,8 +97,24 @@ architecture rtl of acc_linear_function is
 	
 	signal current_state, next_state : state;
 
-	signal input_sample : signed(7 downto 0);
-	signal output_sample : signed(15 downto 0);
+	type input_array is array (0 to G_LANES - 1) of signed(7 downto 0);
+	type output_array is array (0 to G_LANES - 1) of signed(15 downto 0);
+	type byte_array is array (0 to G_LANES - 1) of std_logic_vector(7 downto 0);
+	
+	-- one sample and its result per lane, lane i is in bits 8*i+7 downto 8*i of input data,
+	-- the first pixel of a beat (high order bits) is in the last lane
+	signal input_sample : input_array;
+	signal output_sample : output_array;
+	
+	signal lut_sample : byte_array; -- LUT(X) of samples in input register
+	signal saturated_result : byte_array;
+	signal linear_result : output_array;
+	
+	-- packet signals of beat in input register and in output register
+	signal input_sop, input_eop : std_logic;
+	signal input_empty : unsigned(G_IN_EMPTY_WIDTH - 1 downto 0);
+	signal output_sop, output_eop : std_logic;
+	signal output_empty : unsigned(G_OUT_EMPTY_WIDTH - 1 downto 0);
 	
 	signal int_asi_in_ready : std_logic;
 
@@ -71,10 +123,13 @@ begin
 
 	a_strobe <= '1' when (avs_params_write = '1') and (avs_params_address = A_ADDR) else '0';
 	b_strobe <= '1' when (avs_params_write = '1') and (avs_params_address = B_ADDR) else '0';
+	mode_strobe <= '1' when (avs_params_write = '1') and (avs_params_address = MODE_ADDR) else '0';
+	lut_strobe <= '1' when (avs_params_write = '1') and (avs_params_address = LUT_ADDR) else '0';
 	
 	read_out_mux <= a_reg when (avs_params_address = A_ADDR) else
 						 b_reg when (avs_params_address = B_ADDR) else
-						 "00000000";
+						 "000000" & mode_reg when (avs_params_address = MODE_ADDR) else
+						 std_logic_vector(lut_index);
 	
 	write_reg_a: process(clk, reset)
 	begin
@@ -98,6 +153,53 @@ begin
 		end if;
 	end process;
 
+	write_reg_mode: process(clk, reset)
+	begin
+		if (reset = '1') then
+			mode_reg <= MODE_LINEAR;
+			lut_index <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (mode_strobe = '1') then
+				mode_reg <= avs_params_writedata(1 downto 0);
+				lut_index <= (others => '0');
+			elsif (lut_strobe = '1') then
+				lut_index <= lut_index + 1;
+			end if;
+		end if;
+	end process;
+
+	lanes: for lane in 0 to G_LANES - 1 generate
+		signal lut : lut_type;
+		signal x_operand : signed(8 downto 0);
+		signal product_result : signed(16 downto 0);
+	begin
+-- LUT is read with registered address (input sample as it is written into input register), so
+-- it is placed in block RAM and LUT(X) is ready in the same clock as X in input register.
+-- All lanes get the same table.
+		lut_ram: process(clk)
+		begin
+			if (rising_edge(clk)) then
+				if (lut_strobe = '1') then
+					lut(to_integer(lut_index)) <= avs_params_writedata;
+				end if;
+				if (int_asi_in_ready = '1' and asi_in_valid = '1') then
+					lut_sample(lane) <= lut(to_integer(unsigned(asi_in_data(8*lane + 7 downto 8*lane))));
+				end if;
+			end if;
+		end process;
+
+-- X is signed in linear mode and unsigned pixel value in saturate mode, signed 8x9 bit product fits in 17 bits.
+		x_operand <= resize(input_sample(lane), 9) when (mode_reg = MODE_LINEAR) else signed(resize(unsigned(input_sample(lane)), 9));
+		product_result <= signed(a_reg) * x_operand + resize(signed(b_reg), 17);
+		linear_result(lane) <= product_result(15 downto 0);
+		
+		saturated_result(lane) <= "00000000" when (product_result(16) = '1') else
+										  "11111111" when (product_result(15 downto 8) /= "00000000") else
+										  std_logic_vector(product_result(7 downto 0));
+		
+		aso_out_data(G_OUT_WIDTH*lane + G_OUT_WIDTH - 1 downto G_OUT_WIDTH*lane) <= std_logic_vector(output_sample(lane)(G_OUT_WIDTH - 1 downto 0));
+	end generate;
+
 	read_regs: process(clk, reset)
 	begin
 		if (reset = '1') then
@@ -110,7 +212,10 @@ begin
 	process_sample : process(clk, reset)
 	begin
 		if (reset = '1') then
-			output_sample <= x"BEEF";
+			output_sample <= (others => x"BEEF");
+			output_sop <= '0';
+			output_eop <= '0';
+			output_empty <= (others => '0');
 		elsif (rising_edge(clk)) then
 -- New data can be written in output register only when there is no valid data in output register, or the last data is successfully sent to the output.
 -- In process_inupt state there is no pending data in output register and it can be safely overwritten.
@@ -118,20 +223,43 @@ begin
 -- output streaming interface signals that this data is successfully sent and so the output register can be overwritten with the new data.
 -- In wait_input and wait_output states there is no valid data in the input register which should be processed.
 			if ((current_state = process_input) or ((current_state = full_process or current_state = wait_output_and_process) and aso_out_ready = '1')) then
-				output_sample <= signed(a_reg)*input_sample + signed(b_reg);
+				for lane in 0 to G_LANES - 1 loop
+					case mode_reg is
+						when MODE_SATURATE =>
+							output_sample(lane) <= signed(resize(unsigned(saturated_result(lane)), 16));
+						when MODE_LUT =>
+							output_sample(lane) <= signed(resize(unsigned(lut_sample(lane)), 16));
+						when others =>
+							output_sample(lane) <= linear_result(lane);
+					end case;
+				end loop;
+				output_sop <= input_sop;
+				output_eop <= input_eop;
+				-- every empty input symbol gives G_OUT_WIDTH/8 empty output symbols
+				output_empty <= resize(input_empty * to_unsigned(G_OUT_WIDTH/8, 2), G_OUT_EMPTY_WIDTH);
 			end if;
 		end if;
 	end process;
 	
-	aso_out_data <= std_logic_vector(output_sample);
+	aso_out_sop <= output_sop;
+	aso_out_eop <= output_eop;
+	aso_out_empty <= std_logic_vector(output_empty);
 
 	read_sample : process(clk, reset)
 	begin
 		if (reset = '1') then
-			input_sample <= x"00";
+			input_sample <= (others => x"00");
+			input_sop <= '0';
+			input_eop <= '0';
+			input_empty <= (others => '0');
 		elsif (rising_edge(clk)) then
 			if (int_asi_in_ready = '1' and asi_in_valid = '1') then
-				input_sample <= signed(asi_in_data);
+				for lane in 0 to G_LANES - 1 loop
+					input_sample(lane) <= signed(asi_in_data(8*lane + 7 downto 8*lane));
+				end loop;
+				input_sop <= asi_in_sop;
+				input_eop <= asi_in_eop;
+				input_empty <= unsigned(asi_in_empty);
 			end if;
 		end if;
 	end process;
@@ -224,9 +352,5 @@ begin
 	
 	asi_in_ready <= int_asi_in_ready;
 	
-	aso_out_eop <= '0';
-	aso_out_sop <= '0';
-	aso_out_empty <= '0';
-
 	avs_params_waitrequest <= '0';
 end architecture rtl; -- of acc_linear_function
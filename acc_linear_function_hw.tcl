@@ -31,6 +31,7 @@ set_module_property EDITABLE true
 set_module_property REPORT_TO_TALKBACK false
 set_module_property ALLOW_GREYBOX_GENERATION false
 set_module_property REPORT_HIERARCHY false
+set_module_property ELABORATION_CALLBACK elaborate
 
 
 # 
@@ -46,6 +47,36 @@ add_fileset_file acc_linear_function.vhd VHDL PATH acc_linear_function.vhd TOP_L
 # 
 # parameters
 # 
+add_parameter G_OUT_WIDTH INTEGER 16
+set_parameter_property G_OUT_WIDTH DEFAULT_VALUE 16
+set_parameter_property G_OUT_WIDTH DISPLAY_NAME G_OUT_WIDTH
+set_parameter_property G_OUT_WIDTH DESCRIPTION "16: whole result, 8: low byte of result (chained in front of acc_scale)"
+set_parameter_property G_OUT_WIDTH TYPE INTEGER
+set_parameter_property G_OUT_WIDTH UNITS Bits
+set_parameter_property G_OUT_WIDTH ALLOWED_RANGES {8 16}
+set_parameter_property G_OUT_WIDTH HDL_PARAMETER true
+add_parameter G_LANES INTEGER 1
+set_parameter_property G_LANES DEFAULT_VALUE 1
+set_parameter_property G_LANES DISPLAY_NAME G_LANES
+set_parameter_property G_LANES DESCRIPTION "Pixels processed in one beat, should match data width of the SGDMA feeding the input"
+set_parameter_property G_LANES TYPE INTEGER
+set_parameter_property G_LANES UNITS None
+set_parameter_property G_LANES ALLOWED_RANGES {1 2 4 8}
+set_parameter_property G_LANES HDL_PARAMETER true
+add_parameter G_IN_EMPTY_WIDTH INTEGER 1
+set_parameter_property G_IN_EMPTY_WIDTH DEFAULT_VALUE 1
+set_parameter_property G_IN_EMPTY_WIDTH DISPLAY_NAME G_IN_EMPTY_WIDTH
+set_parameter_property G_IN_EMPTY_WIDTH TYPE INTEGER
+set_parameter_property G_IN_EMPTY_WIDTH UNITS Bits
+set_parameter_property G_IN_EMPTY_WIDTH DERIVED true
+set_parameter_property G_IN_EMPTY_WIDTH HDL_PARAMETER true
+add_parameter G_OUT_EMPTY_WIDTH INTEGER 1
+set_parameter_property G_OUT_EMPTY_WIDTH DEFAULT_VALUE 1
+set_parameter_property G_OUT_EMPTY_WIDTH DISPLAY_NAME G_OUT_EMPTY_WIDTH
+set_parameter_property G_OUT_EMPTY_WIDTH TYPE INTEGER
+set_parameter_property G_OUT_EMPTY_WIDTH UNITS Bits
+set_parameter_property G_OUT_EMPTY_WIDTH DERIVED true
+set_parameter_property G_OUT_EMPTY_WIDTH HDL_PARAMETER true
 
 
 # 
@@ -109,7 +140,7 @@ set_interface_property avs_params PORT_NAME_MAP ""
 set_interface_property avs_params CMSIS_SVD_VARIABLES ""
 set_interface_property avs_params SVD_ADDRESS_GROUP ""
 
-add_interface_port avs_params avs_params_address address Input 1
+add_interface_port avs_params avs_params_address address Input 2
 add_interface_port avs_params avs_params_read read Input 1
 add_interface_port avs_params avs_params_readdata readdata Output 8
 add_interface_port avs_params avs_params_write write Input 1
@@ -138,11 +169,12 @@ set_interface_property asi_in PORT_NAME_MAP ""
 set_interface_property asi_in CMSIS_SVD_VARIABLES ""
 set_interface_property asi_in SVD_ADDRESS_GROUP ""
 
-add_interface_port asi_in asi_in_data data Input 8
+add_interface_port asi_in asi_in_data data Input "((G_LANES*8-1)) - (0) + 1"
 add_interface_port asi_in asi_in_ready ready Output 1
 add_interface_port asi_in asi_in_valid valid Input 1
 add_interface_port asi_in asi_in_eop endofpacket Input 1
 add_interface_port asi_in asi_in_sop startofpacket Input 1
+add_interface_port asi_in asi_in_empty empty Input "((G_IN_EMPTY_WIDTH-1)) - (0) + 1"
 
 
 # 
@@ -162,10 +194,35 @@ set_interface_property aso_out PORT_NAME_MAP ""
 set_interface_property aso_out CMSIS_SVD_VARIABLES ""
 set_interface_property aso_out SVD_ADDRESS_GROUP ""
 
-add_interface_port aso_out aso_out_data data Output 16
+add_interface_port aso_out aso_out_data data Output "((G_OUT_WIDTH*G_LANES-1)) - (0) + 1"
 add_interface_port aso_out aso_out_ready ready Input 1
 add_interface_port aso_out aso_out_valid valid Output 1
 add_interface_port aso_out aso_out_eop endofpacket Output 1
 add_interface_port aso_out aso_out_sop startofpacket Output 1
-add_interface_port aso_out aso_out_empty empty Output 1
+add_interface_port aso_out aso_out_empty empty Output "((G_OUT_EMPTY_WIDTH-1)) - (0) + 1"
+
+
+# 
+# elaboration: widths of empty signals follow the number of lanes, input
+# with a single symbol per beat has no empty signal
+# 
+proc log2_ceil {value} {
+	set bits 0
+	while {(1 << $bits) < $value} {
+		incr bits
+	}
+	return $bits
+}
+
+proc elaborate {} {
+	set lanes [get_parameter_value G_LANES]
+	set out_symbols [expr {$lanes * [get_parameter_value G_OUT_WIDTH] / 8}]
+	set_parameter_value G_IN_EMPTY_WIDTH [expr {max(1, [log2_ceil $lanes])}]
+	set_parameter_value G_OUT_EMPTY_WIDTH [expr {max(1, [log2_ceil $out_symbols])}]
+	if {$lanes == 1} {
+		set_port_property asi_in_empty TERMINATION true
+		set_port_property asi_in_empty TERMINATION_VALUE 0
+	}
+}
+
 
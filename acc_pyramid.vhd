@@ -0,0 +1,316 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+-- Image pyramid accelerator: one input frame of WIDTH x HEIGHT pixels gives up to three decimated
+-- levels at the same time, 1/2 on aso_l1, 1/4 on aso_l2 and 1/8 on aso_l3. Level k keeps pixel
+-- [row,col] when both row and col are multiple of 2^k (the same pixels as acc_scale decrease with
+-- scaling factor 2^k), so the input is read from memory once for all the levels. Every level is a
+-- separate packet on its own source, it is written to memory by its own SGDMA.
+--
+-- Registers (8 bit, byte addresses):
+--   0x0 - 0x3  WIDTH    pixels in one row (little endian)
+--   0x4 - 0x7  HEIGHT   rows in frame (little endian)
+--   0x8        STATUS   bit 0: busy (frame is being processed)
+--   0x9        CONTROL  bit 7: reset (autoreset), bit 6: start (autoreset),
+--                       bits 1-0: number of levels sent (1 - 3, 0 is used as 1)
+--
+-- Input is accepted only when every level that takes the input pixel can take it, level that is
+-- not sent never stalls the input. Start and end of packet of the input are not used.
+
+entity acc_pyramid is
+	port (
+		reset                  : in  std_logic;                     -- reset
+		avs_params_address     : in  std_logic_vector(3 downto 0);  -- params.address
+		avs_params_read        : in  std_logic;                     -- .read
+		avs_params_readdata    : out std_logic_vector(7 downto 0);  -- .readdata
+		avs_params_write       : in  std_logic;                     -- .write
+		avs_params_writedata   : in  std_logic_vector(7 downto 0);  -- .writedata
+		avs_params_waitrequest : out std_logic;                     -- .waitrequest
+		clk                    : in  std_logic;                     -- clock
+		asi_in_data            : in  std_logic_vector(7 downto 0);  -- in.data
+		asi_in_ready           : out std_logic;                     -- .ready
+		asi_in_valid           : in  std_logic;                     -- .valid
+		asi_in_sop             : in  std_logic;                     -- .startofpacket
+		asi_in_eop             : in  std_logic;                     -- .endofpacket
+		aso_l1_data            : out std_logic_vector(7 downto 0);  -- l1.data
+		aso_l1_ready           : in  std_logic;                     -- .ready
+		aso_l1_valid           : out std_logic;                     -- .valid
+		aso_l1_sop             : out std_logic;                     -- .startofpacket
+		aso_l1_eop             : out std_logic;                     -- .endofpacket
+		aso_l2_data            : out std_logic_vector(7 downto 0);  -- l2.data
+		aso_l2_ready           : in  std_logic;                     -- .ready
+		aso_l2_valid           : out std_logic;                     -- .valid
+		aso_l2_sop             : out std_logic;                     -- .startofpacket
+		aso_l2_eop             : out std_logic;                     -- .endofpacket
+		aso_l3_data            : out std_logic_vector(7 downto 0);  -- l3.data
+		aso_l3_ready           : in  std_logic;                     -- .ready
+		aso_l3_valid           : out std_logic;                     -- .valid
+		aso_l3_sop             : out std_logic;                     -- .startofpacket
+		aso_l3_eop             : out std_logic                      -- .endofpacket
+	);
+end entity acc_pyramid;
+
+architecture rtl of acc_pyramid is
+		-- AVALON INTERFACE
+			-- address
+	constant C_ADDR_WIDTH_0  : std_logic_vector(3 downto 0) := "0000";
+	constant C_ADDR_WIDTH_1  : std_logic_vector(3 downto 0) := "0001";
+	constant C_ADDR_WIDTH_2  : std_logic_vector(3 downto 0) := "0010";
+	constant C_ADDR_WIDTH_3  : std_logic_vector(3 downto 0) := "0011";
+	constant C_ADDR_HEIGHT_0 : std_logic_vector(3 downto 0) := "0100";
+	constant C_ADDR_HEIGHT_1 : std_logic_vector(3 downto 0) := "0101";
+	constant C_ADDR_HEIGHT_2 : std_logic_vector(3 downto 0) := "0110";
+	constant C_ADDR_HEIGHT_3 : std_logic_vector(3 downto 0) := "0111";
+	constant C_ADDR_STATUS   : std_logic_vector(3 downto 0) := "1000";
+	constant C_ADDR_CONTROL  : std_logic_vector(3 downto 0) := "1001";
+
+	constant C_LEVELS        : integer := 3;
+
+			-- params registers
+	signal reg_width        : std_logic_vector(31 downto 0);
+	signal reg_height       : std_logic_vector(31 downto 0);
+	signal reg_control      : std_logic_vector(7 downto 0);
+	signal status           : std_logic_vector(7 downto 0);
+	signal read_out_mux     : std_logic_vector(7 downto 0);
+
+	signal strobe_control   : std_logic;
+	signal bit_reset        : std_logic;
+	signal bit_start        : std_logic;
+	signal int_reset        : std_logic;
+
+		-- PYRAMID
+	type State_t is (st_idle, st_run, st_flush);
+	signal reg_current_state : State_t;
+
+	signal levels           : integer range 1 to C_LEVELS;		-- levels sent in current frame
+	signal column           : unsigned(31 downto 0);			-- column of the next input pixel
+	signal row              : unsigned(31 downto 0);			-- row of the next input pixel
+	signal last_column      : unsigned(31 downto 0);
+	signal last_row         : unsigned(31 downto 0);
+	signal transfer         : std_logic;
+	signal can_take         : std_logic;
+
+	type LevelData_t is array (1 to C_LEVELS) of std_logic_vector(7 downto 0);
+	type LevelIndex_t is array (1 to C_LEVELS) of unsigned(31 downto 0);
+	signal take             : std_logic_vector(1 to C_LEVELS);	-- level takes the next input pixel
+	signal out_ready        : std_logic_vector(1 to C_LEVELS);
+	signal out_valid        : std_logic_vector(1 to C_LEVELS);
+	signal out_sop          : std_logic_vector(1 to C_LEVELS);
+	signal out_eop          : std_logic_vector(1 to C_LEVELS);
+	signal out_data         : LevelData_t;
+	signal level_last_column : LevelIndex_t;					-- last column and row kept by level
+	signal level_last_row   : LevelIndex_t;
+
+	-- index with k low bits cleared
+	function level_index(index : unsigned(31 downto 0); k : integer) return unsigned is
+		variable result : unsigned(31 downto 0);
+	begin
+		result := index;
+		result(k-1 downto 0) := (others => '0');
+		return result;
+	end function level_index;
+begin
+---------------------------------------------------------------------------
+-- AVALON INTERFACE
+---------------------------------------------------------------------------
+	strobe_control <= '1' when (avs_params_write = '1') and (avs_params_address = C_ADDR_CONTROL) else '0';
+
+	-- params registers
+	PROC_REG_PARAMS: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_width <= (others => '0');
+			reg_height <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (avs_params_write = '1') then
+				case avs_params_address is
+					when C_ADDR_WIDTH_0  => reg_width(7 downto 0) <= avs_params_writedata;
+					when C_ADDR_WIDTH_1  => reg_width(15 downto 8) <= avs_params_writedata;
+					when C_ADDR_WIDTH_2  => reg_width(23 downto 16) <= avs_params_writedata;
+					when C_ADDR_WIDTH_3  => reg_width(31 downto 24) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_0 => reg_height(7 downto 0) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_1 => reg_height(15 downto 8) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_2 => reg_height(23 downto 16) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_3 => reg_height(31 downto 24) <= avs_params_writedata;
+					when others => null;
+				end case;
+			end if;
+		end if;
+	end process PROC_REG_PARAMS;
+
+	-- reg control, reset and start bits are autoreset
+	PROC_REG_CONTROL: process (clk, reset) is
+	begin
+		if (reset = '1') then
+			reg_control <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (strobe_control = '1') then
+				reg_control <= avs_params_writedata;
+			else
+				reg_control(7 downto 6) <= "00";
+			end if;
+		end if;
+	end process PROC_REG_CONTROL;
+
+	bit_reset <= reg_control(7);
+	bit_start <= reg_control(6);
+
+	-- internal reset that allowes software reset by writing to control register
+	int_reset <= reset or bit_reset;
+
+	-- status
+	status(7 downto 1) <= (others => '0');
+	status(0) <= '0' when (reg_current_state = st_idle) else '1';
+
+	-- read_out_mux
+	read_out_mux <= reg_width(7 downto 0)    when (avs_params_address = C_ADDR_WIDTH_0)  else
+					reg_width(15 downto 8)   when (avs_params_address = C_ADDR_WIDTH_1)  else
+					reg_width(23 downto 16)  when (avs_params_address = C_ADDR_WIDTH_2)  else
+					reg_width(31 downto 24)  when (avs_params_address = C_ADDR_WIDTH_3)  else
+					reg_height(7 downto 0)   when (avs_params_address = C_ADDR_HEIGHT_0) else
+					reg_height(15 downto 8)  when (avs_params_address = C_ADDR_HEIGHT_1) else
+					reg_height(23 downto 16) when (avs_params_address = C_ADDR_HEIGHT_2) else
+					reg_height(31 downto 24) when (avs_params_address = C_ADDR_HEIGHT_3) else
+					status                   when (avs_params_address = C_ADDR_STATUS)   else
+					reg_control              when (avs_params_address = C_ADDR_CONTROL)  else
+					x"00";
+
+	-- reg readdata
+	PROC_REG_READDATA: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			avs_params_readdata <= (others => '0');
+		elsif (rising_edge(clk)) then
+			avs_params_readdata <= read_out_mux;
+		end if;
+	end process PROC_REG_READDATA;
+
+	-- avs_params_read is unused
+	avs_params_waitrequest <= '0';
+
+---------------------------------------------------------------------------
+-- PYRAMID
+---------------------------------------------------------------------------
+	out_ready <= aso_l1_ready & aso_l2_ready & aso_l3_ready;
+
+	-- level k takes pixel whose row and column are multiple of 2^k
+	GEN_TAKE: for k in 1 to C_LEVELS generate
+		take(k) <= '1' when (k <= levels) and (column(k-1 downto 0) = 0) and (row(k-1 downto 0) = 0) else '0';
+	end generate GEN_TAKE;
+
+	-- every level that takes the pixel has free output register (or it is sent in this clk)
+	PROC_CAN_TAKE: process (take, out_valid, out_ready) is
+		variable result : std_logic;
+	begin
+		result := '1';
+		for k in 1 to C_LEVELS loop
+			if ((take(k) = '1') and (out_valid(k) = '1') and (out_ready(k) = '0')) then
+				result := '0';
+			end if;
+		end loop;
+		can_take <= result;
+	end process PROC_CAN_TAKE;
+
+	asi_in_ready <= '1' when (reg_current_state = st_run) and (can_take = '1') else '0';
+	transfer <= '1' when (reg_current_state = st_run) and (can_take = '1') and (asi_in_valid = '1') else '0';
+
+	PROC_PYRAMID: process (clk, int_reset) is
+		variable levels_requested : integer range 0 to C_LEVELS;
+	begin
+		if (int_reset = '1') then
+			reg_current_state <= st_idle;
+			levels <= 1;
+			column <= (others => '0');
+			row <= (others => '0');
+			last_column <= (others => '0');
+			last_row <= (others => '0');
+			level_last_column <= (others => (others => '0'));
+			level_last_row <= (others => (others => '0'));
+		elsif (rising_edge(clk)) then
+			case reg_current_state is
+				when st_idle =>
+					if ((bit_start = '1') and (unsigned(reg_width) /= 0) and (unsigned(reg_height) /= 0)) then
+						reg_current_state <= st_run;
+						levels_requested := to_integer(unsigned(reg_control(1 downto 0)));
+						if (levels_requested = 0) then
+							levels <= 1;
+						else
+							levels <= levels_requested;
+						end if;
+						column <= (others => '0');
+						row <= (others => '0');
+						last_column <= unsigned(reg_width) - 1;
+						last_row <= unsigned(reg_height) - 1;
+						for k in 1 to C_LEVELS loop
+							level_last_column(k) <= level_index(unsigned(reg_width) - 1, k);
+							level_last_row(k) <= level_index(unsigned(reg_height) - 1, k);
+						end loop;
+					end if;
+
+				when st_run =>
+					if (transfer = '1') then
+						if (column = last_column) then
+							column <= (others => '0');
+							row <= row + 1;
+							if (row = last_row) then
+								reg_current_state <= st_flush;
+							end if;
+						else
+							column <= column + 1;
+						end if;
+					end if;
+
+				when st_flush =>
+					-- frame is done when the last pixel of every level is sent
+					if (out_valid = "000") then
+						reg_current_state <= st_idle;
+					end if;
+			end case;
+		end if;
+	end process PROC_PYRAMID;
+
+	-- output register of every level
+	PROC_OUTPUTS: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			out_valid <= (others => '0');
+			out_sop <= (others => '0');
+			out_eop <= (others => '0');
+			out_data <= (others => (others => '0'));
+		elsif (rising_edge(clk)) then
+			for k in 1 to C_LEVELS loop
+				if ((transfer = '1') and (take(k) = '1')) then
+					out_valid(k) <= '1';
+					out_data(k) <= asi_in_data;
+					if ((row = 0) and (column = 0)) then
+						out_sop(k) <= '1';
+					else
+						out_sop(k) <= '0';
+					end if;
+					if ((row = level_last_row(k)) and (column = level_last_column(k))) then
+						out_eop(k) <= '1';
+					else
+						out_eop(k) <= '0';
+					end if;
+				elsif (out_ready(k) = '1') then
+					out_valid(k) <= '0';
+				end if;
+			end loop;
+		end if;
+	end process PROC_OUTPUTS;
+
+	aso_l1_valid <= out_valid(1);
+	aso_l1_data <= out_data(1);
+	aso_l1_sop <= out_sop(1);
+	aso_l1_eop <= out_eop(1);
+	aso_l2_valid <= out_valid(2);
+	aso_l2_data <= out_data(2);
+	aso_l2_sop <= out_sop(2);
+	aso_l2_eop <= out_eop(2);
+	aso_l3_valid <= out_valid(3);
+	aso_l3_data <= out_data(3);
+	aso_l3_sop <= out_sop(3);
+	aso_l3_eop <= out_eop(3);
+
+end architecture rtl;
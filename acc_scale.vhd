@@ -66,16 +66,36 @@ architecture rtl of acc_scale is
     signal reg_height   : std_logic_vector(31 downto 0);
     signal scale        : std_logic_vector(G_SCALE_WIDTH-1 downto 0);
     
-			-- ram
+			-- ram (synchronous read, so it is inferred as block ram)
 	type Mem_t is array (0 to 2**G_MAX_ROW_WIDTH-1) of std_logic_vector(7 downto 0);
 	signal memory_ram : Mem_t;	--pravimo ram
+	signal ram_q      : std_logic_vector(7 downto 0);
 	
 			-- ram control signals
     signal ram_wr : std_logic;	--postavim ness na ulaz kad je ovo 1 upisuj u ram
+    signal ram_rd : std_logic;
+    signal ram_rd_pending : std_logic;	-- ram_q holds pixel read in previous clk
     
+			-- output fifo (skid buffer between ram read and source side)
+	constant C_OUT_FIFO_DEPTH : integer := 4;
+	type Fifo_t is array (0 to C_OUT_FIFO_DEPTH-1) of std_logic_vector(7 downto 0);
+	signal out_fifo          : Fifo_t;
+	signal out_fifo_wr_ptr   : unsigned(1 downto 0);
+	signal out_fifo_rd_ptr   : unsigned(1 downto 0);
+	signal out_fifo_count    : unsigned(2 downto 0);
+	signal out_fifo_push     : std_logic;
+	signal out_fifo_pop      : std_logic;
+    
+			-- crc32 of output stream
+    signal reg_crc      : std_logic_vector(31 downto 0);
+    signal crc          : std_logic_vector(31 downto 0);
+
 			-- streaming
+    signal int_aso_out_data  : std_logic_vector(7 downto 0);
     signal int_asi_in_ready  : std_logic;	--postavljeni kao interni da bi proveravali izlaz
     signal int_aso_out_valid : std_logic;	--jer vhdl ne mozes da proveravas izlazni signal pa mora interni
+    signal core_out_valid    : std_logic;	-- pixel at output_index is ready to be sent
+    signal core_out_ready    : std_logic;	-- output fifo has space for pixel read from ram
     
     type State_t is (st_reset, st_buffer_not_full, st_buffer_full, st_buffer_rewrite);
     signal reg_current_state, next_state : State_t;
@@ -93,7 +113,11 @@ architecture rtl of acc_scale is
 		constant C_ADDR_HEIGHT_3  : std_logic_vector(3 downto 0) := x"7";
 		constant C_ADDR_STATUS    : std_logic_vector(3 downto 0) := x"8";
 		constant C_ADDR_CONTROL   : std_logic_vector(3 downto 0) := x"9";
-		--imamo adrese od 0-9 do 10 je reserved
+		constant C_ADDR_CRC_0     : std_logic_vector(3 downto 0) := x"A";
+		constant C_ADDR_CRC_1     : std_logic_vector(3 downto 0) := x"B";
+		constant C_ADDR_CRC_2     : std_logic_vector(3 downto 0) := x"C";
+		constant C_ADDR_CRC_3     : std_logic_vector(3 downto 0) := x"D";
+		--imamo adrese od 0-D, od E su reserved
 	
 			-- signals
 			-- strobe			POSTAVIMO ADRESU I WRITE, AKO JE moja adresa i write, onda se generise strobe
@@ -124,6 +148,21 @@ architecture rtl of acc_scale is
 			-- other
 	signal read_out_mux 	: std_logic_vector(7 downto 0);
 	signal reg_control  	: std_logic_vector(7 downto 0);
+
+	-- crc32 (IEEE 802.3, reflected) of one byte, same as zlib crc32 without final inversion
+	function crc32_update(crc_in : std_logic_vector(31 downto 0); data : std_logic_vector(7 downto 0)) return std_logic_vector is
+		variable c : std_logic_vector(31 downto 0);
+	begin
+		c := crc_in;
+		for i in 0 to 7 loop
+			if ((c(0) xor data(i)) = '1') then
+				c := ('0' & c(31 downto 1)) xor x"EDB88320";
+			else
+				c := '0' & c(31 downto 1);
+			end if;
+		end loop;
+		return c;
+	end function crc32_update;
 begin
 ---------------------------------------------------------------------------
 -- AVALON INTERFACE	MI SMO AVALON KORISTILI ANALOGNO, ZATO ANALOGNO GENERISEMO SIGNALE RAZLIKA JE U TOME STO IMAMO 10 ADResa
@@ -151,6 +190,10 @@ begin
 					reg_height_3 	when (avs_params_address = C_ADDR_HEIGHT_3) else
 					status 			when (avs_params_address = C_ADDR_STATUS) 	else
 					reg_control 	when (avs_params_address = C_ADDR_CONTROL) 	else
+					crc(7 downto 0) 	when (avs_params_address = C_ADDR_CRC_0) 	else
+					crc(15 downto 8) 	when (avs_params_address = C_ADDR_CRC_1) 	else
+					crc(23 downto 16) 	when (avs_params_address = C_ADDR_CRC_2) 	else
+					crc(31 downto 24) 	when (avs_params_address = C_ADDR_CRC_3) 	else
 					x"00";
 	
 	-- reg width 0
@@ -252,7 +295,7 @@ begin
     -- status
     status(7 downto 1) <= (others => '0');
     status(0) <= bit_busy;
-	bit_busy <= '0' when (reg_current_state = st_reset) else '1';
+	bit_busy <= '0' when ((reg_current_state = st_reset) and (ram_rd_pending = '0') and (out_fifo_count = 0)) else '1';
 	
 	-- reg control autoreset (upper 2 bits)
 	PROC_REG_CONTROL_AUTORESET: process (clk, reset) is
@@ -283,6 +326,24 @@ begin
 
 	reg_control <= reg_control_autoreset & reg_control_no_autoreset;
 
+	-- crc32 of output stream (read only), restarted when frame is started and
+	-- kept after frame is done until the next start
+	PROC_REG_CRC: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_crc <= (others => '1');
+		elsif (rising_edge(clk)) then
+			if ((reg_current_state = st_reset) and (bit_start = '1')) then
+				reg_crc <= (others => '1');
+			elsif ((aso_out_ready = '1') and (int_aso_out_valid = '1')) then
+				-- output transfer occured / pixel was sent
+				reg_crc <= crc32_update(reg_crc, int_aso_out_data);
+			end if;
+		end if;
+	end process PROC_REG_CRC;
+
+	crc <= not reg_crc;
+
 	-- reg readdata
 	PROC_REG_READDATA: process (clk, int_reset) is
 	begin
@@ -408,7 +469,7 @@ begin
         end if;
     end process PROC_CNT_ROWS_LEFT;
 
-    LOGIC_COUNTER_CONTROL: process (reg_current_state, bit_start, bit_increase, asi_in_valid, int_asi_in_ready, int_aso_out_valid, aso_out_ready, input_index, output_index, pixel_scale, row_scale, scale) is
+    LOGIC_COUNTER_CONTROL: process (reg_current_state, bit_start, bit_increase, asi_in_valid, int_asi_in_ready, core_out_valid, core_out_ready, input_index, output_index, pixel_scale, row_scale, scale) is
     begin 
     	input_index_decrease    <= '0';
         output_index_decrease   <= '0';
@@ -444,7 +505,7 @@ begin
                 -- decrease
                 if ((row_scale = unsigned(scale)-1) and (pixel_scale = unsigned(scale)-1)) then
                     -- this pixel needs to be sent
-                    if (aso_out_ready = '1' and int_aso_out_valid = '1') then
+                    if (core_out_ready = '1' and core_out_valid = '1') then
                         -- pixel was sent
                         pixel_scale_decrease <= '1';
                         output_index_decrease <= '1';
@@ -468,7 +529,7 @@ begin
                 end if;
             else
                 -- increase
-                if ((aso_out_ready = '1') and (int_aso_out_valid = '1')) then
+                if ((core_out_ready = '1') and (core_out_valid = '1')) then
                     -- output transfer occured / pixel was sent
                     pixel_scale_decrease <= '1';
                     if (pixel_scale = 0) then
@@ -489,22 +550,76 @@ begin
     end process LOGIC_COUNTER_CONTROL;
                      
 -- ram
-	-- write ram memory process
+	-- write and read ram memory process, read data is registered so the
+	-- line buffer is inferred as block ram (one clk read latency)
 	PROC_RAM: process (clk) is
 	begin
 		if (rising_edge(clk)) then
 			if (ram_wr = '1') then
 				memory_ram(to_integer(input_index)) <= asi_in_data;
 			end if;
+			ram_q <= memory_ram(to_integer(output_index));
 		end if;
 	end process PROC_RAM;
 
-	-- read ram memory process
-	aso_out_data <= memory_ram(to_integer(unsigned(output_index)));
-
 	-- ram write control signal
     ram_wr <= '1' when ((int_asi_in_ready = '1') and (asi_in_valid = '1')) else '0';
 
+	-- ram read control signal, pixel at output_index is sent to output fifo
+    ram_rd <= '1' when ((core_out_ready = '1') and (core_out_valid = '1')) else '0';
+
+	PROC_RAM_RD_PENDING: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			ram_rd_pending <= '0';
+		elsif (rising_edge(clk)) then
+			ram_rd_pending <= ram_rd;
+		end if;
+	end process PROC_RAM_RD_PENDING;
+
+-- output fifo
+	-- pixel read from ram is written to fifo one clk after it was read. space
+	-- for it is reserved when it is read, so fifo accepts it even if source
+	-- side is stalled meanwhile. with depth 4 there is always space for one
+	-- pixel per clk while source side is ready.
+	core_out_ready <= '1' when ((out_fifo_count + ("00" & ram_rd_pending)) < C_OUT_FIFO_DEPTH) else '0';
+
+	out_fifo_push <= ram_rd_pending;
+	out_fifo_pop  <= '1' when ((aso_out_ready = '1') and (int_aso_out_valid = '1')) else '0';
+
+	PROC_OUT_FIFO_DATA: process (clk) is
+	begin
+		if (rising_edge(clk)) then
+			if (out_fifo_push = '1') then
+				out_fifo(to_integer(out_fifo_wr_ptr)) <= ram_q;
+			end if;
+		end if;
+	end process PROC_OUT_FIFO_DATA;
+
+	PROC_OUT_FIFO_CONTROL: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			out_fifo_wr_ptr <= (others => '0');
+			out_fifo_rd_ptr <= (others => '0');
+			out_fifo_count  <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (out_fifo_push = '1') then
+				out_fifo_wr_ptr <= out_fifo_wr_ptr + 1;
+			end if;
+			if (out_fifo_pop = '1') then
+				out_fifo_rd_ptr <= out_fifo_rd_ptr + 1;
+			end if;
+			if ((out_fifo_push = '1') and (out_fifo_pop = '0')) then
+				out_fifo_count <= out_fifo_count + 1;
+			elsif ((out_fifo_push = '0') and (out_fifo_pop = '1')) then
+				out_fifo_count <= out_fifo_count - 1;
+			end if;
+		end if;
+	end process PROC_OUT_FIFO_CONTROL;
+
+	int_aso_out_data  <= out_fifo(to_integer(out_fifo_rd_ptr));
+	int_aso_out_valid <= '0' when (out_fifo_count = 0) else '1';
+
 -- streaming                     
     
     PROC_REG_CURRENT_STATE: process (clk, int_reset) is
@@ -516,7 +631,7 @@ begin
         end if;
     end process PROC_REG_CURRENT_STATE;
     
-    LOGIC_STREAMING_PROTOCOL: process (reg_current_state, bit_start, bit_increase, asi_in_valid, aso_out_ready, input_index, output_index, pixel_scale, row_scale, rows_left, scale) is
+    LOGIC_STREAMING_PROTOCOL: process (reg_current_state, bit_start, bit_increase, asi_in_valid, core_out_ready, input_index, output_index, pixel_scale, row_scale, rows_left, scale) is
     begin
         case (reg_current_state) is
             when st_reset =>    
@@ -526,7 +641,7 @@ begin
                 int_asi_in_ready <= '0';
                 
                 --source side
-                int_aso_out_valid <= '0';
+                core_out_valid <= '0';
                 
                 if (bit_start = '1') then
 					-- FSM will be in running state on next clk 
@@ -549,18 +664,18 @@ begin
                 end if;
                 
                 -- source side
-                int_aso_out_valid <= '0';
+                core_out_valid <= '0';
                 if (bit_increase = '0') then
                     -- decrease
                     if ((output_index > input_index) and ((row_scale = unsigned(scale)-1) and (pixel_scale = unsigned(scale)-1))) then
                     	-- if unprocessed pixel is available and needs to be sent
-                        int_aso_out_valid <= '1';
+                        core_out_valid <= '1';
                     end if;
                 else
                     -- increase
                     if (output_index > input_index) then
                         -- if any unprocessed pixel is available
-                        int_aso_out_valid <= '1';
+                        core_out_valid <= '1';
                     end if;
                 end if;
             when st_buffer_full =>
@@ -570,8 +685,8 @@ begin
                 int_asi_in_ready <= '0';
                 
                 -- source side
-                int_aso_out_valid <= '1';
-                if ((aso_out_ready = '1') and (pixel_scale = 0) and (output_index = 0) and (row_scale = 1)) then
+                core_out_valid <= '1';
+                if ((core_out_ready = '1') and (pixel_scale = 0) and (output_index = 0) and (row_scale = 1)) then
                     -- last pixel in row was sent and row_scale = 1
                     next_state <= st_buffer_rewrite;
                 end if;
@@ -586,13 +701,13 @@ begin
             end if;
             
             -- source side
-            int_aso_out_valid <= '0';
+            core_out_valid <= '0';
             if (bit_increase = '0') then
             	-- decrease
                 if ((row_scale = unsigned(scale)-1) and (pixel_scale = unsigned(scale)-1)) then
                      -- this pixel needs to be sent
-                    int_aso_out_valid <= '1';
-                    if ((aso_out_ready = '1') and (output_index = 0)) then
+                    core_out_valid <= '1';
+                    if ((core_out_ready = '1') and (output_index = 0)) then
                     	-- last pixel in row was sent
                         if (rows_left = 0) then
                             -- this was last row
@@ -614,8 +729,8 @@ begin
                 end if;
             else
             	-- increase
-                int_aso_out_valid <= '1';
-                if ((aso_out_ready = '1') and (pixel_scale = 0) and (output_index = 0)) then
+                core_out_valid <= '1';
+                if ((core_out_ready = '1') and (pixel_scale = 0) and (output_index = 0)) then
                     -- last pixel in row was sent
                     if (rows_left = 0) then
                         -- this was last row
@@ -633,6 +748,7 @@ begin
     -- asi_in_eop is unused
     aso_out_sop 	<= '0';
     aso_out_eop 	<= '0';
+    aso_out_data 	<= int_aso_out_data;
     asi_in_ready 	<= int_asi_in_ready;
     aso_out_valid 	<= int_aso_out_valid;   
     
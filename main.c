@@ -9,19 +9,147 @@
 
 	Two SGDMA components are used in this system since Avalon-ST is a
 	uni-directional point to point method of connecting IP.
+
+	acc_linear_function (with G_OUT_WIDTH 8) can be chained in front of acc_scale in the qsys
+	system, so point operation (y = a*x + b) and scaling are done in one pass through memory:
+	SSRAM(MM) --> (MM)SGDMA(ST) --> (ST)LINEAR FUNCTION(ST) --> (ST)ACCELERATOR(ST) --> (ST)SGDMA(MM) --> SSRAM(MM)
+	chain is used when system.h has ACC_LINEAR_FUNCTION_BASE (see FUSED_PIPELINE), otherwise
+	point operation is done by NIOS after scaling.
+
+	For throughput tests acc_scale can be placed between stream_generator and stream_checker
+	instead of SGDMAs, so it is measured without SGDMA and SDRAM limits:
+	(ST)GENERATOR(ST) --> (ST)ACCELERATOR(ST) --> (ST)CHECKER
+	traffic test is available when system.h has STREAM_GENERATOR_BASE and STREAM_CHECKER_BASE
+	(see TRAFFIC_TEST).
+
+	System can have more acc_scale instances, each one with its own pair of SGDMAs (acc_scale_1
+	with sgdma_m2s_1 and sgdma_s2m_1 and so on, see ACC_SCALE_INSTANCES). Batch jobs are then
+	split into bands of rows that are dispatched to idle instances (see dispatchScaleWork), NIOS
+	scales bands too while all the instances are busy (see BAND_SW_WORKER).
+
+	Image pyramid (1/2, 1/4 and 1/8 of input) is made by acc_pyramid from one read of input:
+	SSRAM(MM) --> (MM)SGDMA(ST) --> (ST)PYRAMID(ST) x3 --> (ST)SGDMA(MM) x3 --> SSRAM(MM)
+	every level has its own source and SGDMA, it is used when system.h has ACC_PYRAMID_BASE (see
+	HW_PYRAMID), otherwise NIOS makes all the levels in one walk over input.
+
+	The same program can be built on a linux host with HOST_BUILD set to 1
+	(gcc -DHOST_BUILD=1 main.c -lpthread -lm). Only software processing is available there,
+	input images are memory mapped, scaling runs on a thread pool (one row band per
+	core) and performance is measured with clock_gettime.
 */
 
+// set to greater than 0 for building on linux host (software processing only, no NIOS HAL)
+#ifndef HOST_BUILD
+#define HOST_BUILD 0
+#endif
+
 #include <ctype.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if HOST_BUILD>0
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#else
 #include "alt_types.h"
 #include "altera_avalon_performance_counter.h"
 #include "altera_avalon_sgdma.h"
 #include "altera_avalon_sgdma_regs.h"
+#include "sys/alt_alarm.h"
 #include "sys/alt_cache.h"
 #include "system.h"
+#endif
+
+#if HOST_BUILD>0
+/*
+	------------------------------------------------------------------------------------------------
+	host replacements for the parts of NIOS HAL used by this program
+
+	performance counter sections are measured in nanoseconds (cpu frequency is reported as 1GHz)
+	------------------------------------------------------------------------------------------------
+*/
+typedef int8_t		alt_8;
+typedef uint8_t		alt_u8;
+typedef int16_t		alt_16;
+typedef uint16_t	alt_u16;
+typedef int32_t		alt_32;
+typedef uint32_t	alt_u32;
+typedef int64_t		alt_64;
+typedef uint64_t	alt_u64;
+
+// sgdma is never opened on host, pointers to it are always NULL
+typedef struct alt_sgdma_dev alt_sgdma_dev;
+typedef struct alt_sgdma_descriptor alt_sgdma_descriptor;
+
+#define PERFORMANCE_COUNTER_BASE 	0
+#define HOST_PERF_SECTIONS_MAX 		8
+
+static alt_u32 host_perf_measuring;
+static alt_u64 host_perf_total_start;
+static alt_u64 host_perf_total_time;
+static alt_u64 host_perf_section_start[HOST_PERF_SECTIONS_MAX];
+static alt_u64 host_perf_section_time[HOST_PERF_SECTIONS_MAX];
+
+static alt_u64 hostTimeNs(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (alt_u64)now.tv_sec * 1000000000ULL + (alt_u64)now.tv_nsec;
+}
+
+#define PERF_RESET(base) 				(memset(host_perf_section_time, 0, sizeof(host_perf_section_time)), host_perf_total_time = 0)
+#define PERF_START_MEASURING(base) 		(host_perf_total_start = hostTimeNs(), host_perf_measuring = 1)
+#define PERF_STOP_MEASURING(base) 		(host_perf_total_time += hostTimeNs() - host_perf_total_start, host_perf_measuring = 0)
+#define PERF_BEGIN(base, section) 		(host_perf_section_start[section] = hostTimeNs())
+#define PERF_END(base, section) 		(host_perf_section_time[section] += hostTimeNs() - host_perf_section_start[section])
+
+#define alt_get_cpu_freq() 				1000000000ULL
+
+// system timer ticks are microseconds
+#define alt_ticks_per_second() 			1000000
+#define alt_nticks() 					((alt_u32)(hostTimeNs() / 1000))
+
+static alt_u64 perf_get_section_time(void *base, alt_u32 section) {
+	(void)base;
+	return host_perf_section_time[section];
+}
+
+static alt_u64 perf_get_total_time(void *base) {
+	(void)base;
+	return host_perf_total_time + (host_perf_measuring ? hostTimeNs() - host_perf_total_start : 0);
+}
+
+static void perf_print_formatted_report(alt_u32 base, alt_u64 clock_freq, alt_u32 sections, ...) {
+	va_list names;
+	(void)base;
+	(void)clock_freq;
+
+	va_start(names, sections);
+	printf("--Performance Counter Report--\n");
+	printf("Total Time: %.6f seconds\n", perf_get_total_time(NULL) / 1e9);
+	for (alt_u32 i = 1; i <= sections; i++) {
+		printf("%-12s %.6f seconds\n", va_arg(names, char*), host_perf_section_time[i] / 1e9);
+	}
+	va_end(names);
+}
+#endif
 
 // set to greater than 0 for extensive printf during operation
 #define VERBOSE_LEVEL 0
@@ -32,10 +160,103 @@
 // filename lenght limits
 #define INPUT_FILENAME_MAX_LEN 	20
 #define OUTPUT_FILENAME_MAX_LEN 40
+#define BATCH_FILENAME_MAX_LEN 	128
+#define BATCH_LINE_MAX_LEN 		(2 * BATCH_FILENAME_MAX_LEN + 64)
+
+// host directories
+#define INPUT_DIRECTORY 	"/mnt/host/input/"
+#define OUTPUT_DIRECTORY 	"/mnt/host/output/"
+#define PATH_MAX_LEN 		(BATCH_FILENAME_MAX_LEN + 20)
 
 // output filename templates
-#define OUTPUT_FILENAME_SW "/mnt/host/output/out_sw"
-#define OUTPUT_FILENAME_HW "/mnt/host/output/out_hw"
+#define OUTPUT_FILENAME_SW OUTPUT_DIRECTORY "out_sw"
+#define OUTPUT_FILENAME_HW OUTPUT_DIRECTORY "out_hw"
+
+// set to greater than 0 for validating hw results of every batch job (while transfer is running)
+#define BATCH_VALIDATE_RESULTS 1
+// set to greater than 0 for validating hw results by comparing crc32 computed by acc_scale with
+// crc32 expected from input image, rows are compared only if crc32 does not match
+#define VALIDATE_WITH_HW_CRC 1
+
+// fit to box batch jobs (see planFitToBox): estimated cycles per pixel of acc_scale stage when its
+// scaling is not calibrated yet (pixel in and pixel out over shared sdram), cycles per output pixel
+// of residual resize done by NIOS and cycles per data cache line it reads from sdram
+#define FIT_HW_CYCLES_PER_PIXEL 	2
+#define FIT_SW_RESIZE_CYCLES 		6
+#define FIT_SW_LINE_CYCLES 			40
+
+// set to greater than 0 for splitting batch jobs between acc_scale (top rows) and NIOS (bottom rows),
+// split is chosen from hw and sw speed measured by calibration run and stored in calibration file
+#define HYBRID_PROCESSING 			1
+#define HYBRID_CALIBRATION_FILENAME OUTPUT_DIRECTORY "hybrid_calibration.bin"
+#define HYBRID_CALIBRATION_MAGIC 	0x4C414348	// "HCAL"
+#define HYBRID_CALIBRATION_SIZE 	512			// width and height of calibration input image
+// sw part smaller than 1/HYBRID_MIN_SW_SHARE of output image is not worth splitting off
+#define HYBRID_MIN_SW_SHARE 		32
+
+// acc_scale instances: instance 0 is acc_scale with sgdma_m2s and sgdma_s2m, instance k is
+// acc_scale_k with sgdma_m2s_k and sgdma_s2m_k (system.h has ACC_SCALE_k_BASE). on host
+// HOST_ACC_SCALE_MODEL instances are modeled in software, so dispatching of bands can be checked
+// without hw (0 - batch jobs use thread pool instead)
+#define HOST_ACC_SCALE_MODEL 		0
+#if HOST_BUILD>0
+#if HOST_ACC_SCALE_MODEL>0
+#define ACC_SCALE_INSTANCES 		HOST_ACC_SCALE_MODEL
+#else
+#define ACC_SCALE_INSTANCES 		1
+#endif
+#elif defined(ACC_SCALE_3_BASE)
+#define ACC_SCALE_INSTANCES 		4
+#elif defined(ACC_SCALE_2_BASE)
+#define ACC_SCALE_INSTANCES 		3
+#elif defined(ACC_SCALE_1_BASE)
+#define ACC_SCALE_INSTANCES 		2
+#else
+#define ACC_SCALE_INSTANCES 		1
+#endif
+// band with less input pixels is not worth another instance (descriptors and interrupts per band)
+#define ACC_SCALE_BAND_MIN_PIXELS 	(64 * 1024)
+#define ACC_SCALE_BANDS_PER_INSTANCE 2			// smaller bands even out instances and NIOS
+#define BANDS_MAX 					16			// bands of one image
+// NIOS takes band when every instance is busy and the rest of bands keeps instances busy at least
+// until NIOS is done (needs hybrid calibration, on host modeled NIOS is ACC_SCALE_MODEL_SW_CLOCKS
+// clocks per output pixel)
+#define BAND_SW_WORKER 				1
+// host model: acc_scale takes or gives one pixel per clock, sdram moves ACC_SCALE_MODEL_SDRAM_BYTES
+// bytes per clock for all the instances together (16 bit sdram at system clock)
+#define ACC_SCALE_MODEL_SDRAM_BYTES 2
+#define ACC_SCALE_MODEL_STEP 		64			// clocks modeled between two polls of dispatcher
+#define ACC_SCALE_MODEL_SW_CLOCKS 	8
+
+// tiled image files: images with this extension are stored in tiles, so part of image can be read
+// without reading whole file. batch job with scaling factor 1 converts between .bin and .tbin
+#define TILED_IMAGE_EXTENSION 	".tbin"
+#define TILED_IMAGE_MAGIC 		0x474D4954	// "TIMG"
+#define TILED_IMAGE_TILE_SIZE 	64
+#define TILED_IMAGE_TILE_SIZE_MAX 	4096	// bigger tile size in file is taken as corrupted header
+#define TILED_IMAGE_COMPRESSION TILE_RLE
+
+// number of threads used for software scaling on host, 0 means one per online core
+#define HOST_SW_THREADS 		0
+#define HOST_SW_THREADS_MAX 	64
+// 1 - use SSSE3/AVX2 (x86) or NEON (arm) row kernels on host when cpu supports them
+#define HOST_SW_SIMD 			1
+
+// input tile of swProcessImage, 0 means whole rows (see swProcessImageTiled)
+#define SW_TILE_WIDTH 			0
+#define SW_TILE_HEIGHT 			0
+
+// bytes moved by one call to host file system (jtag semihosting has large per call overhead)
+#define FILE_IO_CHUNK_SIZE 			(1024 * 1024)
+
+// batch jobs with at least this many input pixels are streamed in bands of rows instead of loaded whole
+#define STREAMING_MIN_INPUT_SIZE 	(4 * 1024 * 1024)
+// memory used by input and output band buffers while streaming
+#define STREAMING_BUFFER_SIZE 		(1024 * 1024)
+
+// frame job compares input with previous frame in tiles of this many input pixels in both
+// directions, multiple of every scaling factor so tile of decrease starts on kept pixel
+#define FRAME_TILE_SIZE 			96
 
 // scaling factor range / limits
 #define SCALING_FACTOR_MIN 1
@@ -47,6 +268,18 @@
 #define BIGGEST_32BIT_UNSIGNED_NUMBER 4294967295
 #define BIGGEST_16BIT_UNSIGNED_NUMBER 65535
 
+// size of memory arena all job buffers are taken from (see Arena_t). it has to hold the largest
+// job: input image, output image, descriptors and tiles. bigger batch inputs are streamed in bands.
+#if HOST_BUILD>0
+#define JOB_ARENA_SIZE 			(256 * 1024 * 1024)
+#else
+#define JOB_ARENA_SIZE 			(16 * 1024 * 1024)
+#endif
+
+// alignment of buffers that DMA reads or writes, at least data cache line size of NIOS (32 bytes
+// is the biggest line size and also alignment that sgdma descriptors need)
+#define DMA_BUFFER_ALIGNMENT 	32
+
 // HW related constants
 #define ADDR_WIDTH_0 	0x0
 #define ADDR_WIDTH_1 	0x1
@@ -58,11 +291,66 @@
 #define ADDR_HEIGHT_3 	0x7
 #define ADDR_STATUS 	0x8
 #define ADDR_CONTROL 	0x9
+#define ADDR_CRC_0 		0xA
+#define ADDR_CRC_1 		0xB
+#define ADDR_CRC_2 		0xC
+#define ADDR_CRC_3 		0xD
 
 #define BIT_CONTROL_RESET 		0x80
 #define BIT_CONTROL_START 		0x40
 #define BIT_CONTROL_INCREASE 	0x20
 
+// acc_linear_function chained in front of acc_scale (sgdma_m2s -> acc_linear_function -> acc_scale -> sgdma_s2m)
+#if HOST_BUILD==0 && defined(ACC_LINEAR_FUNCTION_BASE)
+#define FUSED_PIPELINE 			1
+#else
+#define FUSED_PIPELINE 			0
+#endif
+#define ADDR_LINEAR_A 		0x0
+#define ADDR_LINEAR_B 		0x1
+#define ADDR_LINEAR_MODE 	0x2		// writing mode resets LUT write index
+#define ADDR_LINEAR_LUT 	0x3		// every write stores one LUT entry, index moves to the next one
+
+#define LINEAR_MODE_LINEAR 		0x0
+#define LINEAR_MODE_SATURATE 	0x1
+#define LINEAR_MODE_LUT 		0x2
+
+// biggest exponent of gamma point operation
+#define POINT_GAMMA_MAX 		10
+
+// stream_generator and stream_checker around acc_scale (both have the same layout of registers)
+#if HOST_BUILD==0 && defined(STREAM_GENERATOR_BASE) && defined(STREAM_CHECKER_BASE)
+#define TRAFFIC_TEST 			1
+#else
+#define TRAFFIC_TEST 			0
+#endif
+#define ADDR_STREAM_WIDTH 		0x00	// 4 bytes, little endian
+#define ADDR_STREAM_HEIGHT 		0x04	// 4 bytes, little endian
+#define ADDR_STREAM_STATUS 		0x08
+#define ADDR_STREAM_CONTROL 	0x09
+#define ADDR_STREAM_VALUE 		0x0A	// first pixel of ramp, seed of prbs, constant pixel
+#define ADDR_STREAM_GAP_PERIOD 	0x0B	// generator: pixels between valid gaps, checker: pixels between ready drops
+#define ADDR_STREAM_GAP_LENGTH 	0x0C	// clocks in one gap/drop
+#define ADDR_STREAM_CYCLES 		0x10	// generator: start to the last pixel, checker: the first to the last pixel
+#define ADDR_STREAM_STALLS 		0x14	// generator: clocks with valid and without ready
+#define ADDR_STREAM_ERRORS 		0x14	// checker: pixels different from pattern
+#define ADDR_STREAM_IDLE 		0x18	// checker: clocks with ready and without valid
+#define ADDR_STREAM_CRC 		0x1C	// checker: crc32 of received pixels
+
+#define BIT_STREAM_STATUS_BUSY 		0x01
+#define BIT_STREAM_CONTROL_COMPARE 	0x04
+
+#define TRAFFIC_TIMEOUT_SECONDS 	2
+
+// acc_pyramid fed by sgdma_m2s_pyramid, level k written by sgdma_s2m_pyramid_k (registers from
+// WIDTH to CONTROL have the same layout as registers of acc_scale)
+#if HOST_BUILD==0 && defined(ACC_PYRAMID_BASE)
+#define HW_PYRAMID 				1
+#else
+#define HW_PYRAMID 				0
+#endif
+#define PYRAMID_LEVELS_MAX 		3		// level k is 1/2^k of input
+
 // typedefs
 typedef enum { SF1=SCALING_FACTOR_MIN, SF2, SF3, SF4 } ScalingFactor_t;
 
@@ -70,6 +358,33 @@ typedef enum { DECREASE, INCREASE } IncreaseDecreaseResolution_t;
 
 typedef enum { WHOLE, PART } PartOfImageToProcess_t;
 
+// point operation done on every pixel before scaling
+typedef enum { POINT_NONE, POINT_LINEAR, POINT_SATURATE, POINT_LUT } PointOperationType_t;
+
+typedef struct {
+	PointOperationType_t type;
+	alt_8 a;			// POINT_LINEAR: y = a*x + b with signed x, low byte of y is the result (as acc_linear_function with G_OUT_WIDTH 8)
+	alt_8 b;			// POINT_SATURATE: y = a*x + b with unsigned x, saturated to [0,255]
+	alt_u8 lut[256];	// POINT_LUT: y = lut[x]
+} PointOperation_t;
+
+// pixels sent by stream_generator (values of control register bits 1-0)
+typedef enum { PATTERN_RAMP, PATTERN_PRBS, PATTERN_CONSTANT } StreamPattern_t;
+
+// one frame of traffic test
+typedef struct {
+	alt_u32 width;
+	alt_u32 height;
+	ScalingFactor_t scaling_factor;
+	IncreaseDecreaseResolution_t increase_decrease;
+	StreamPattern_t pattern;
+	alt_u8 value;
+	alt_u8 gap_period;		// valid of generator is dropped for gap_length clocks after every gap_period pixels
+	alt_u8 gap_length;
+	alt_u8 ready_period;	// ready of checker is dropped for ready_length clocks after every ready_period pixels
+	alt_u8 ready_length;
+} TrafficCase_t;
+
 typedef struct {
 	PartOfImageToProcess_t whole_part;
 	alt_u32 row;
@@ -81,9 +396,125 @@ typedef struct {
 typedef struct {
 	alt_u32 width;
 	alt_u32 height;
-	alt_u8 **pixels;
+	alt_u32 stride;		// number of bytes between starts of two consecutive rows
+	alt_u8 *pixels;		// top left pixel, pixel [row,col] is pixels[row * stride + col]
 } Image_t ;
 
+// memory block taken from job arena, it only grows during a job and is emptied between jobs
+// memory starts and ends on DMA_BUFFER_ALIGNMENT boundary, so it never shares a cache line with
+// other data and cache lines of it can be flushed/invalidated without touching anything else
+typedef struct {
+	void *memory;
+	alt_u32 size;
+	alt_u64 mapped;		// length of read only file mapping, 0 if memory is taken from arena (host build only)
+} ReusableBuffer_t;
+
+// one block of memory allocated at start, job buffers are taken from it one after another
+typedef struct {
+	void *allocation;	// block returned by malloc, memory lies inside of it
+	alt_u8 *memory;		// aligned to DMA_BUFFER_ALIGNMENT
+	alt_u32 size;
+	alt_u32 used;
+	alt_u32 kept;		// bytes at start of memory kept between jobs (see frame sequence)
+} Arena_t;
+
+typedef struct {
+	ReusableBuffer_t input_image;
+	ReusableBuffer_t output_image;
+	ReusableBuffer_t m2s_descriptors;
+	ReusableBuffer_t s2m_descriptors;
+	ReusableBuffer_t tiles;		// compressed and decompressed tiles of tiled images
+	ReusableBuffer_t frame_tiles;	// changed tiles of tile row of frame job
+	ReusableBuffer_t resized_image;	// output of residual resize of fit to box job
+	ReusableBuffer_t pyramid_images[PYRAMID_LEVELS_MAX];			// levels of pyramid job
+	ReusableBuffer_t pyramid_s2m_descriptors[PYRAMID_LEVELS_MAX];
+	ReusableBuffer_t band_m2s_descriptors[ACC_SCALE_INSTANCES];		// descriptors of band dispatched to acc_scale instance
+	ReusableBuffer_t band_s2m_descriptors[ACC_SCALE_INSTANCES];
+} JobBuffers_t;
+
+// band of a job given to one acc_scale instance, views into input and output image of the job
+typedef struct {
+	Image_t input_image;
+	Image_t output_image;
+} ScaleWork_t;
+
+typedef struct {
+	alt_u32 base;						// acc_scale registers
+	alt_sgdma_dev *m2s;
+	alt_sgdma_dev *s2m;
+	volatile alt_u16 *tx_done_p;
+	volatile alt_u16 *rx_done_p;
+	alt_sgdma_descriptor *s2m_desc;		// receive descriptors of work in progress
+	const ScaleWork_t *work;			// NULL when instance is idle
+	alt_u32 bands;						// bands and output pixels done since program start
+	alt_u64 output_pixels;
+	double model_clocks_left;			// host model: clocks left at full speed
+	double model_bytes_per_clock;		// host model: sdram bytes per clock at full speed
+} AccScaleInstance_t;
+
+typedef enum { TILE_RAW, TILE_RLE } TileCompression_t;
+
+// header of tiled image file, followed by tile index and tile data
+typedef struct {
+	alt_u32 magic;
+	alt_u32 width;
+	alt_u32 height;
+	alt_u32 tile_size;		// tiles are tile_size x tile_size pixels, tiles in last column/row are clipped
+	alt_u32 compression;	// TileCompression_t
+} TiledImageHeader_t;
+
+// one entry per tile, tiles are indexed row by row
+typedef struct {
+	alt_u32 offset;			// from start of file
+	alt_u32 size;			// tile is stored raw when size is equal to number of its pixels
+} TileIndexEntry_t;
+
+typedef struct {
+	alt_8 input_filename[BATCH_FILENAME_MAX_LEN];
+	alt_8 output_filename[BATCH_FILENAME_MAX_LEN];
+	ScalingFactor_t scaling_factor;
+	IncreaseDecreaseResolution_t increase_decrease;
+	ImagePartParameters_t image_part_parameters;
+	PointOperation_t point_operation;
+	alt_u32 fit_width;		// fit to box job: output fits into fit_width x fit_height box, 0 otherwise
+	alt_u32 fit_height;
+	alt_u32 pyramid_levels;	// pyramid job: levels 1/2 to 1/2^pyramid_levels, 0 otherwise
+	alt_u32 frame;			// frame job: only tiles changed since previous frame job are scaled
+} BatchJob_t;
+
+// fit to box: optional acc_scale stage, then optional residual resize by NIOS (nearest neighbour)
+typedef struct {
+	alt_u32 hw_stage;		// 0 - input goes straight to residual resize
+	ScalingFactor_t scaling_factor;
+	IncreaseDecreaseResolution_t increase_decrease;
+	alt_u32 residual;		// output of acc_scale stage is resized to width x height
+	alt_u32 width;
+	alt_u32 height;
+	alt_u64 cycles;			// estimate
+} FitPlan_t;
+
+// previous frame job, kept at start of job arena for the next one
+typedef struct {
+	ReusableBuffer_t input_buffer;
+	ReusableBuffer_t output_buffer;
+	Image_t input_image;		// input of previous frame, changed tiles are copied into it
+	Image_t output_image;		// output of previous frame, changed tiles are scaled into it
+	ScalingFactor_t scaling_factor;
+	IncreaseDecreaseResolution_t increase_decrease;
+	PointOperation_t point_operation;
+	alt_u32 frames;				// frames of sequence so far, 0 if there is no sequence
+} FrameSequence_t;
+
+// bytes moved and system timer ticks spent in host file system calls
+typedef struct {
+	alt_u64 bytes;
+	alt_u32 calls;
+	alt_u32 ticks;
+} IoStatistics_t;
+
+static IoStatistics_t io_read_statistics;
+static IoStatistics_t io_write_statistics;
+
 /*
 	------------------------------------------------------------------------------------------------
 	parses user input
@@ -209,16 +640,300 @@ alt_u32 partOfImageUserInput(ImagePartParameters_t* image_part_parameters) {
 
 /*
 	------------------------------------------------------------------------------------------------
-	creates buffer for input image in dynamic memory and reads pixel values from bin input file
+	memory arena of job buffers
 
-	read input image width, height and pixels from binary file
+	arena is allocated once when program starts. buffers are taken from it one after another and
+	all of them are given back at once when next job starts, so heap is never touched between jobs
+	and it can not get fragmented.
+	------------------------------------------------------------------------------------------------
+*/
+static Arena_t job_arena;
+
+alt_u32 createArena(Arena_t *arena, alt_u32 size) {
+	arena->allocation = malloc(size + DMA_BUFFER_ALIGNMENT - 1);
+	if (arena->allocation == NULL) {
+		printf("ERROR: Unable to allocate %u bytes of job memory.\n", (unsigned int)size);
+		return 1;
+	}
+	arena->memory = (alt_u8*)(((uintptr_t)arena->allocation + DMA_BUFFER_ALIGNMENT - 1) & ~(uintptr_t)(DMA_BUFFER_ALIGNMENT - 1));
+	arena->size = size & ~(alt_u32)(DMA_BUFFER_ALIGNMENT - 1);
+	arena->used = 0;
+	return 0;
+}
+
+void destroyArena(Arena_t *arena) {
+	free(arena->allocation);
+	memset(arena, 0, sizeof(Arena_t));
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	frees memory held by reusable buffer
+
+	arena memory is given back only by resetJobBuffers, file mapping is unmapped right away
+	------------------------------------------------------------------------------------------------
+*/
+void releaseBuffer(ReusableBuffer_t *buffer) {
+#if HOST_BUILD>0
+	if (buffer->mapped) {
+		munmap(buffer->memory, (size_t)buffer->mapped);
+	}
+#endif
+	buffer->memory = NULL;
+	buffer->size = 0;
+	buffer->mapped = 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	empties all job buffers and gives whole arena back, called before every job
+
+	memory kept by frame sequence at start of arena stays (see frameSequenceEnd)
+	------------------------------------------------------------------------------------------------
+*/
+void resetJobBuffers(JobBuffers_t *job_buffers) {
+	releaseBuffer(&(job_buffers->input_image));
+	releaseBuffer(&(job_buffers->output_image));
+	releaseBuffer(&(job_buffers->m2s_descriptors));
+	releaseBuffer(&(job_buffers->s2m_descriptors));
+	releaseBuffer(&(job_buffers->tiles));
+	releaseBuffer(&(job_buffers->frame_tiles));
+	releaseBuffer(&(job_buffers->resized_image));
+	for (alt_u32 i = 0; i < PYRAMID_LEVELS_MAX; i++) {
+		releaseBuffer(&(job_buffers->pyramid_images[i]));
+		releaseBuffer(&(job_buffers->pyramid_s2m_descriptors[i]));
+	}
+	for (alt_u32 i = 0; i < ACC_SCALE_INSTANCES; i++) {
+		releaseBuffer(&(job_buffers->band_m2s_descriptors[i]));
+		releaseBuffer(&(job_buffers->band_s2m_descriptors[i]));
+	}
+	job_arena.used = job_arena.kept;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	makes sure reusable buffer holds at least size bytes
+
+	memory is taken from job arena only when buffer is too small. buffer that was the last one
+	taken from arena grows in place (and keeps its content). size is rounded up to
+	DMA_BUFFER_ALIGNMENT and memory is aligned to it.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 reserveBuffer(ReusableBuffer_t *buffer, alt_u32 size) {
+	if (buffer->size >= size && !buffer->mapped) {
+		return 0;
+	}
+
+	// checking potential overflow that may occur as a result of addition
+	if (size > BIGGEST_32BIT_UNSIGNED_NUMBER - DMA_BUFFER_ALIGNMENT) {
+		printf("ERROR: Unable to allocate %u bytes of buffer memory.\n", (unsigned int)size);
+		return 1;
+	}
+	size = (size + DMA_BUFFER_ALIGNMENT - 1) & ~(alt_u32)(DMA_BUFFER_ALIGNMENT - 1);
+
+	if (!buffer->mapped && buffer->memory != NULL && (alt_u8*)buffer->memory + buffer->size == job_arena.memory + job_arena.used) {
+		// last buffer in arena
+		job_arena.used -= buffer->size;
+	} else {
+		releaseBuffer(buffer);
+	}
+
+	if (size > job_arena.size - job_arena.used) {
+		buffer->memory = NULL;
+		buffer->size = 0;
+		printf("ERROR: Unable to allocate %u bytes of buffer memory, job needs more than %u bytes.\n",
+				(unsigned int)size, (unsigned int)job_arena.size);
+		return 1;
+	}
+	buffer->memory = job_arena.memory + job_arena.used;
+	buffer->size = size;
+	job_arena.used += size;
+
+#if VERBOSE_LEVEL>0
+    printf("reserveBuffer: %u bytes\n", (unsigned int)size);
+#endif
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	places image with already set width and height into reusable buffer
+
+	rows are stored one after another, so stride is equal to width
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 allocateImage(Image_t *image, ReusableBuffer_t *buffer) {
+
+	// checking potential overflow that may occur as a result of multiplication
+	if (image->width != 0 && (BIGGEST_32BIT_UNSIGNED_NUMBER / image->width) < image->height) {
+		printf("ERROR: Image can not be stored in memory, it is too big.\n");
+		return 1;
+	}
+
+	if (reserveBuffer(buffer, image->width * image->height)) {
+		return 1;
+	}
+
+	image->stride = image->width;
+	image->pixels = (alt_u8*)buffer->memory;
+	return 0;
+}
+
+#if HOST_BUILD>0
+/*
+	------------------------------------------------------------------------------------------------
+	maps bin input file into memory and uses pixel values in place (host build only)
+
+	file is mapped read only, input image points right after width and height in the mapping.
+	mapping is owned by the buffer and it is unmapped when buffer is reused or released.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 mapImage(alt_8 *path, Image_t *input_image, ReusableBuffer_t *buffer) {
+	int input_file;
+	struct stat input_file_stat;
+	alt_u32 header[2];
+	void *mapping;
+
+	input_file = open((char*)path, O_RDONLY);
+	if (input_file < 0) {
+        printf("ERROR: Unable to open file \"%s\"!\n", path);
+		return 1;
+	}
+
+	if (fstat(input_file, &input_file_stat) || input_file_stat.st_size < (off_t)sizeof(header)) {
+        printf("ERROR: File \"%s\" is not a valid image!\n", path);
+		close(input_file);
+		return 1;
+	}
+
+	mapping = mmap(NULL, input_file_stat.st_size, PROT_READ, MAP_PRIVATE, input_file, 0);
+	close(input_file);
+	if (mapping == MAP_FAILED) {
+        printf("ERROR: Unable to map file \"%s\"!\n", path);
+		return 1;
+	}
+
+	// read image width and height
+	memcpy(header, mapping, sizeof(header));
+	input_image->width = header[0];
+	input_image->height = header[1];
+	if ((alt_u64)input_image->width * input_image->height > (alt_u64)input_file_stat.st_size - sizeof(header)) {
+        printf("ERROR: File \"%s\" is shorter than its width and height require!\n", path);
+		munmap(mapping, input_file_stat.st_size);
+		return 1;
+	}
+#if VERBOSE_LEVEL>0
+    printf("input_image_width = %u\n", (unsigned int)input_image->width);
+	printf("input_image_height = %u\n", (unsigned int)input_image->height);
+#endif
+
+	// buffer takes over the mapping
+	releaseBuffer(buffer);
+	buffer->memory = mapping;
+	buffer->size = 0;
+	buffer->mapped = (alt_u64)input_file_stat.st_size;
+
+	input_image->stride = input_image->width;
+	input_image->pixels = (alt_u8*)mapping + sizeof(header);
+
+	// pixels are read row after row
+	madvise(mapping, input_file_stat.st_size, MADV_SEQUENTIAL);
+
+#if VERBOSE_LEVEL>0
+	printf("mapImage end.\n");
+#endif
+	return 0;
+}
+#endif
+
+/*
+	------------------------------------------------------------------------------------------------
+	reads block of bytes from file in as few calls as possible (FILE_IO_CHUNK_SIZE bytes per call)
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 readBlock(FILE *file, void *destination, alt_u64 size) {
+	alt_u8 *position = (alt_u8*)destination;
+	alt_u32 start = alt_nticks();
+
+	while (size > 0) {
+		alt_u32 chunk = (size < FILE_IO_CHUNK_SIZE) ? (alt_u32)size : FILE_IO_CHUNK_SIZE;
+		io_read_statistics.calls++;
+		if (fread(position, chunk, 1, file) != 1) {
+			io_read_statistics.ticks += alt_nticks() - start;
+			return 1;
+		}
+		io_read_statistics.bytes += chunk;
+		position += chunk;
+		size -= chunk;
+	}
+	io_read_statistics.ticks += alt_nticks() - start;
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	writes block of bytes to file in as few calls as possible (FILE_IO_CHUNK_SIZE bytes per call)
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 writeBlock(FILE *file, const void *source, alt_u64 size) {
+	const alt_u8 *position = (const alt_u8*)source;
+	alt_u32 start = alt_nticks();
+
+	while (size > 0) {
+		alt_u32 chunk = (size < FILE_IO_CHUNK_SIZE) ? (alt_u32)size : FILE_IO_CHUNK_SIZE;
+		io_write_statistics.calls++;
+		if (fwrite(position, chunk, 1, file) != 1) {
+			io_write_statistics.ticks += alt_nticks() - start;
+			return 1;
+		}
+		io_write_statistics.bytes += chunk;
+		position += chunk;
+		size -= chunk;
+	}
+	io_write_statistics.ticks += alt_nticks() - start;
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	prints bytes, calls and achieved MB/s of file reads and writes since last report
+	------------------------------------------------------------------------------------------------
+*/
+void printIoReport() {
+	IoStatistics_t *statistics[2] = { &io_read_statistics, &io_write_statistics };
+	const char *names[2] = { "File read:", "File write:" };
+
+	for (alt_u32 i = 0; i < 2; i++) {
+		if (statistics[i]->calls == 0) {
+			continue;
+		}
+		printf("%-20s%llu bytes in %u calls", names[i],
+				(unsigned long long)statistics[i]->bytes, (unsigned int)statistics[i]->calls);
+		if (statistics[i]->ticks > 0) {
+			printf(", %.2f MB/s", (double)statistics[i]->bytes * alt_ticks_per_second() / statistics[i]->ticks / (1024 * 1024));
+		}
+		printf("\n");
+		memset(statistics[i], 0, sizeof(IoStatistics_t));
+	}
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	opens bin input file and reads input image width and height
+
+	file is left open at the first pixel, caller closes it
 	------------------------------------------------------------------------------------------------
 */
-alt_u32 loadImage(alt_8 *input_filename, Image_t *input_image) {
+FILE *openImage(alt_8 *input_filename, Image_t *input_image) {
     FILE *ptr_input_file;
 	
 	// nios compatible filename
-    alt_8 input_filename_nios[INPUT_FILENAME_MAX_LEN+10] = {'/','m','n','t','/','h','o','s','t','/','i','n','p','u','t','/','\0'};
+    alt_8 input_filename_nios[PATH_MAX_LEN];
+    if (strlen((char*)input_filename) + sizeof(INPUT_DIRECTORY) > PATH_MAX_LEN) {
+        printf("ERROR: Input filename \"%s\" is too long\n", input_filename);
+        return NULL;
+    }
+    strcpy((char*)input_filename_nios, INPUT_DIRECTORY);
     strcat((char*)input_filename_nios, (char*)input_filename);
 #if VERBOSE_LEVEL>0
     printf("Input filename with ext: %s\n", input_filename_nios);
@@ -229,45 +944,83 @@ alt_u32 loadImage(alt_8 *input_filename, Image_t *input_image) {
     if (ptr_input_file == NULL)
     {
         printf("ERROR: Unable to open file \"%s\"!\n", input_filename);
-        return 1;
+        return NULL;
     }
 
     // read image width and height
-    fread(&(input_image->width),sizeof(input_image->width),1,ptr_input_file);
-	fread(&(input_image->height),sizeof(input_image->height),1,ptr_input_file);
+    if (fread(&(input_image->width),sizeof(input_image->width),1,ptr_input_file) != 1 ||
+		fread(&(input_image->height),sizeof(input_image->height),1,ptr_input_file) != 1) {
+        printf("ERROR: File \"%s\" is not a valid image!\n", input_filename);
+        fclose(ptr_input_file);
+        return NULL;
+    }
 #if VERBOSE_LEVEL>0
     printf("input_image_width = %u\n", (unsigned int)input_image->width);
 	printf("input_image_height = %u\n", (unsigned int)input_image->height);
 #endif
+    return ptr_input_file;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	creates buffer for input image in dynamic memory and reads pixel values from opened input file
+
+	width and height are already read by openImage
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 readImage(FILE *ptr_input_file, Image_t *input_image, ReusableBuffer_t *buffer) {
 
     // allocate buffer for input image
-	input_image->pixels = (alt_u8**)malloc(input_image->height * sizeof(alt_u8*));
-	if (input_image->pixels == NULL) {
+	if (allocateImage(input_image, buffer)) {
         printf("ERROR: Unable to allocate buffer for input image.\n");
         return 1;
     }
-	for (alt_u32 i = 0; i < input_image->height; i++) {
-		(input_image->pixels)[i] = (alt_u8*)malloc(input_image->width * sizeof(alt_u8));
-		if ((input_image->pixels)[i] == NULL) {
-			printf("ERROR: Unable to allocate buffer for input image.\n");
-			for(alt_u32 j = 0; j < i; j++) {
-				free((input_image->pixels)[j]);
-			}
-			free(input_image->pixels);
-			return 1;
-		}
-    }
 
     // read all the pixels
 #if VERBOSE_LEVEL>0
 	printf("Start of reading all the pixels from file into input image buffer.\n");
 #endif
-	for (alt_u32 i = 0; i < input_image->height; i++) {
-		fread((input_image->pixels)[i],input_image->width * sizeof(alt_u8),1,ptr_input_file);
-    }
+	// allocated image is packed, so all pixels are read as one block
+	if (readBlock(ptr_input_file, input_image->pixels, (alt_u64)input_image->width * input_image->height * sizeof(alt_u8))) {
+        printf("ERROR: Input file is shorter than image width and height require.\n");
+        return 1;
+	}
 #if VERBOSE_LEVEL>0
 	printf("End of reading all the pixels from file into input image buffer.\n");
 #endif
+    return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	creates buffer for input image in dynamic memory and reads pixel values from bin input file
+
+	read input image width, height and pixels from binary file
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 loadImage(alt_8 *input_filename, Image_t *input_image, ReusableBuffer_t *buffer) {
+#if HOST_BUILD>0
+	// on host, file is mapped and pixels are used in place
+    alt_8 input_filename_nios[PATH_MAX_LEN];
+    if (strlen((char*)input_filename) + sizeof(INPUT_DIRECTORY) > PATH_MAX_LEN) {
+        printf("ERROR: Input filename \"%s\" is too long\n", input_filename);
+        return 1;
+    }
+    strcpy((char*)input_filename_nios, INPUT_DIRECTORY);
+    strcat((char*)input_filename_nios, (char*)input_filename);
+    return mapImage(input_filename_nios, input_image, buffer);
+#else
+    FILE *ptr_input_file;
+    alt_u32 result;
+
+    // open input file and read image width and height
+    ptr_input_file = openImage(input_filename, input_image);
+    if (ptr_input_file == NULL) {
+        return 1;
+    }
+
+    // read all the pixels
+    result = readImage(ptr_input_file, input_image, buffer);
 
     // close input file
     fclose(ptr_input_file);
@@ -275,18 +1028,19 @@ alt_u32 loadImage(alt_8 *input_filename, Image_t *input_image) {
 #if VERBOSE_LEVEL>0
 	printf("loadImage end.\n");
 #endif
-    return 0;
+    return result;
+#endif
 }
 
 /*
 	------------------------------------------------------------------------------------------------
 	form input image based on part of image input instructions
+
+	part of image is only a view (offset and stride) into already loaded image, nothing is copied
 	------------------------------------------------------------------------------------------------
 */
 alt_u32 formInputImage(ImagePartParameters_t image_part_parameters, Image_t *image) {
 
-	alt_u8 **temp;
-
 	// if whole image needs to be processed nothing needs to change => just exit
 	if (image_part_parameters.whole_part == WHOLE) {
 		return 0;
@@ -302,39 +1056,10 @@ alt_u32 formInputImage(ImagePartParameters_t image_part_parameters, Image_t *ima
 		return 1;
 	}
 
-    // allocate buffer for new input image
-	temp = (alt_u8**)malloc(image_part_parameters.height * sizeof(alt_u8*));
-	if (temp == NULL) {
-        printf("ERROR: Unable to allocate buffer for new input image.\n");
-        return 1;
-    }
-	for (alt_u32 i = 0; i < image_part_parameters.height; i++) {
-		temp[i] = (alt_u8*)malloc(image_part_parameters.width * sizeof(alt_u8));
-		if (temp[i] == NULL) {
-			printf("ERROR: Unable to allocate buffer for new input image.\n");
-			for(alt_u32 j = 0; j < i; j++) {
-				free(temp[j]);
-			}
-			free(temp);
-			return 1;
-		}
-    }
-
-	for (alt_u32 i = 0; i < image_part_parameters.height; i++) {
-		for (alt_u32 j = 0; j < image_part_parameters.width; j++) {
-			temp[i][j] = (image->pixels)[image_part_parameters.row + i][image_part_parameters.col + j];
-		}
-	}
-
-    // free dynamic memory
-	for(alt_u32 i = 0; i < image->height; i++) {
-		free((image->pixels)[i]);
-	}
-	free(image->pixels);
-
+	// part of image is a view into the same buffer, stride stays the same so nothing is copied
+	image->pixels += image_part_parameters.row * image->stride + image_part_parameters.col;
 	image->height = image_part_parameters.height;
 	image->width = image_part_parameters.width;
-	image->pixels = temp;
 	
 #if VERBOSE_LEVEL>0
     printf("input_image_height = %u\n", (unsigned int)image->height);
@@ -346,12 +1071,13 @@ alt_u32 formInputImage(ImagePartParameters_t image_part_parameters, Image_t *ima
 
 /*
 	------------------------------------------------------------------------------------------------
-	creates buffer for output image in dynamic memory
+	calculates output image width and height
 
-	form output image buffer and parameters
+	on decrease every scaling_factor-th pixel of every scaling_factor-th row is kept, starting
+	with the first one, so rows and columns are rounded up independently
 	------------------------------------------------------------------------------------------------
 */
-alt_u32 formOutputImage(
+alt_u32 outputImageSize(
 		ScalingFactor_t scaling_factor,
 		IncreaseDecreaseResolution_t increase_decrease,
 		Image_t input_image,
@@ -376,31 +1102,46 @@ alt_u32 formOutputImage(
 		if (input_image.height % scaling_factor) {
 			// mod != 0
 			output_image->height = input_image.height / scaling_factor + 1;
-			output_image->width  = input_image.width  / scaling_factor + 1;
 		} else {
 			// mod = 0
 			output_image->height = input_image.height / scaling_factor;
+		}
+
+		if (input_image.width % scaling_factor) {
+			// mod != 0
+			output_image->width  = input_image.width  / scaling_factor + 1;
+		} else {
+			// mod = 0
 			output_image->width  = input_image.width  / scaling_factor;
 		}
     }
+    return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	creates buffer for output image in dynamic memory
+
+	form output image buffer and parameters
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 formOutputImage(
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t *output_image,
+		ReusableBuffer_t *buffer) {
+
+    // form output image width and height
+    if (outputImageSize(scaling_factor, increase_decrease, input_image, output_image)) {
+        return 1;
+    }
 
     // allocate buffer for output image
-	output_image->pixels = (alt_u8**)malloc(output_image->height * sizeof(alt_u8*));
-	if (output_image->pixels == NULL) {
+	if (allocateImage(output_image, buffer)) {
         printf("ERROR: Unable to allocate buffer for output image.\n");
         return 1;
     }
-	for (alt_u32 i = 0; i < output_image->height; i++) {
-		(output_image->pixels)[i] = (alt_u8*)malloc(output_image->width * sizeof(alt_u8));
-		if ((output_image->pixels)[i] == NULL) {
-			printf("ERROR: Unable to allocate buffer for output image.\n");
-			for(alt_u32 j = 0; j < i; j++) {
-				free((output_image->pixels)[j]);
-			}
-			free(output_image->pixels);
-			return 1;
-		}
-    }
 
 #if VERBOSE_LEVEL>0
     printf("output_image_height = %u\n", (unsigned int)output_image->height);
@@ -412,12 +1153,14 @@ alt_u32 formOutputImage(
 
 /*
 	------------------------------------------------------------------------------------------------
-	does acc_scale to image utilising NIOS processor
+	does acc_scale to image utilising NIOS processor, one pixel at a time
+
+	reference implementation, row kernels used by swProcessImage are checked against it
 
 	process: input image ---> output image
 	------------------------------------------------------------------------------------------------
 */
-alt_u32 swProcessImage(
+alt_u32 swProcessImageReference(
         ScalingFactor_t scaling_factor,
         IncreaseDecreaseResolution_t increase_decrease,
         Image_t input_image,
@@ -430,7 +1173,7 @@ alt_u32 swProcessImage(
         alt_u32 in_col = 0;
         for(alt_u32 out_row = 0; out_row < output_image.height; out_row++) {
 			for(alt_u32 out_col = 0; out_col < output_image.width; out_col++) {
-				(output_image.pixels)[out_row][out_col] = (input_image.pixels)[in_row][in_col];
+				output_image.pixels[out_row * output_image.stride + out_col] = input_image.pixels[in_row * input_image.stride + in_col];
 
 				col_mul_cnt++;
 
@@ -455,9 +1198,9 @@ alt_u32 swProcessImage(
         alt_u32 in_col = 0;
 		for(alt_u32 out_row = 0; out_row < output_image.height; out_row++) {
 			for(alt_u32 out_col = 0; out_col < output_image.width; out_col++) {
-				(output_image.pixels)[out_row][out_col] = (input_image.pixels)[in_row][in_col];
+				output_image.pixels[out_row * output_image.stride + out_col] = input_image.pixels[in_row * input_image.stride + in_col];
 
-				if (in_col >= input_image.width - scaling_factor) {
+				if (in_col + scaling_factor >= input_image.width) {
 					in_row += scaling_factor;
 					in_col = 0;
 				} else {
@@ -468,478 +1211,4540 @@ alt_u32 swProcessImage(
     }
 
 #if VERBOSE_LEVEL>0
-    printf("swProcessImage end.\n");
+    printf("swProcessImageReference end.\n");
 #endif
     return 0;
 }
 
 /*
 	------------------------------------------------------------------------------------------------
-	stores output image pixel values in bin output file
-
-	write output image width, height and pixels to binary file
+	row kernels of software scaling
+
+	kernel makes one output row from one input row: increase repeats every input pixel
+	scaling_factor times, decrease takes every scaling_factor-th input pixel. kernel is chosen
+	once per image by swSelectRowKernel from table indexed by direction and scaling factor.
+	scalar kernels are generated for every scaling factor, so loops over factor are unrolled.
+	vectorized kernels (host build only) process whole vectors while they fit into the row and
+	leave the rest to the scalar loop, so all kernels give the same result as
+	swProcessImageReference.
 	------------------------------------------------------------------------------------------------
 */
-alt_u32 storeImage(alt_8 *filename, Image_t image) {
-    FILE *ptr_output_file;
-
-    // open output file
-    ptr_output_file = fopen((char*)filename,"wb");
-    if (ptr_output_file == NULL)
-    {
-        printf("Unable to open file \"%s\"!\n", filename);
-        return 1;
-    }
+typedef void (*SwRowKernel_t)(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width);
 
-    // write image width and height
-    fwrite(&(image.width),sizeof(image.width),1,ptr_output_file);
-	fwrite(&(image.height),sizeof(image.height),1,ptr_output_file);
+typedef struct {
+	const char *name;
+	SwRowKernel_t kernels[INCREASE + 1][SCALING_FACTOR_MAX + 1];	// [increase_decrease][scaling_factor]
+} SwRowKernels_t;
 
-    // write all the pixels
-	for (alt_u32 i = 0; i < image.height; i++) {
-		fwrite((image.pixels)[i],image.width * sizeof(alt_u8),1,ptr_output_file);
-    }
+static void copyRow(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)input_width;
+	memcpy(output_row, input_row, output_width);
+}
 
-    // close output file
-    fclose(ptr_output_file);
+// scalar kernels of scaling factor F, F is constant so loop over it is fully unrolled
+#define SW_SCALAR_ROW_KERNELS(F) \
+static void replicateRow##F(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) { \
+	(void)output_width; \
+	for (alt_u32 in_col = 0; in_col < input_width; in_col++) { \
+		alt_u8 pixel = input_row[in_col]; \
+		for (alt_u32 k = 0; k < F; k++) { \
+			output_row[k] = pixel; \
+		} \
+		output_row += F; \
+	} \
+} \
+static void decimateRow##F(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) { \
+	(void)input_width; \
+	for (alt_u32 out_col = 0; out_col < output_width; out_col++) { \
+		output_row[out_col] = input_row[out_col * F]; \
+	} \
+}
 
-#if VERBOSE_LEVEL>0
-    printf("storeImage end.\n");
-#endif
-    return 0;
+SW_SCALAR_ROW_KERNELS(2)
+SW_SCALAR_ROW_KERNELS(3)
+SW_SCALAR_ROW_KERNELS(4)
+
+static const SwRowKernels_t sw_row_kernels_scalar = {
+	"scalar",
+	{ { NULL, copyRow, decimateRow2, decimateRow3, decimateRow4 },
+	  { NULL, copyRow, replicateRow2, replicateRow3, replicateRow4 } }
+};
+
+#if HOST_BUILD>0 && (defined(__x86_64__) || defined(__i386__) || defined(__ARM_NEON))
+// finish rows of vectorized kernels from first_col on
+static void replicateRowScalar(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 scaling_factor, alt_u32 first_col) {
+	alt_u8 *output_pixel = output_row + first_col * scaling_factor;
+	for (alt_u32 in_col = first_col; in_col < input_width; in_col++) {
+		for (alt_u32 k = 0; k < scaling_factor; k++) {
+			*output_pixel++ = input_row[in_col];
+		}
+	}
 }
 
+static void decimateRowScalar(const alt_u8 *input_row, alt_u8 *output_row, alt_u32 output_width, alt_u32 scaling_factor, alt_u32 first_col) {
+	for (alt_u32 out_col = first_col; out_col < output_width; out_col++) {
+		output_row[out_col] = input_row[out_col * scaling_factor];
+	}
+}
+#endif
 
+#if HOST_BUILD>0 && (defined(__x86_64__) || defined(__i386__))
 /*
-	------------------------------------------------------------------------------------------------
-	Allocating descriptor table space from main memory.
-	------------------------------------------------------------------------------------------------
+	SSSE3: increase unpacks (x2, x4) or shuffles (x3) 16 input pixels at a time,
+	decrease packs (/2, /4) or shuffles (/3) 16 output pixels at a time
 */
-alt_u32 createDescriptors(
-		alt_sgdma_descriptor ** transmit_descriptors_p,
-        alt_sgdma_descriptor ** transmit_descriptors_copy_p,
-        alt_sgdma_descriptor ** receive_descriptors_p,
-        alt_sgdma_descriptor ** receive_descriptors_copy_p,
-		Image_t input_image,
-		Image_t output_image)
-{
-	/* Allocate some big buffers to hold all descriptors which will slide until
-	 * the first 32 byte boundary is found */
-	void * temp_ptr;
-	alt_u32 input_desctiptors_count;
-	alt_u32 output_desctiptors_count;
-	alt_u32 input_desctiptors_count_row;
-	alt_u32 output_desctiptors_count_row;
-	alt_sgdma_descriptor *transmit_descriptors, *receive_descriptors;
-	alt_u32 current_descriptor;
-
-	/*
-	   * Allocation of the transmit descriptors                   *
-	   * - First allocate a large buffer to the temporary pointer *
-	   * - Second check for successful memory allocation          *
-	   * - Third put this memory location into the pointer copy   *
-	   *   to be freed before the program exits                   *
-	   * - Forth slide the temporary pointer until it lies on a 32*
-	   *   byte boundary (descriptor master is 256 bits wide)     */
-
-	// calculate number of descriptors for input image
-	// number of rows * number of descriptors per row
-	if (input_image.width % DESCRIPTOR_BUFFER_LEN_MAX) {
-		// checking potential overflow that may occur as a result of multiplication
-		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (input_image.width / DESCRIPTOR_BUFFER_LEN_MAX + 1)) < input_image.height) {
-			printf("ERROR: While allocating descriptors. Input image is too big.\n");
-			return 1;
-		}
-		input_desctiptors_count_row = input_image.width / DESCRIPTOR_BUFFER_LEN_MAX + 1;
-		input_desctiptors_count = input_image.height * input_desctiptors_count_row;
-	} else {
-		// checking potential overflow that may occur as a result of multiplication
-		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (input_image.width / DESCRIPTOR_BUFFER_LEN_MAX)) < input_image.height) {
-			printf("ERROR: While allocating descriptors. Input image is too big.\n");
-			return 1;
-		}
-		input_desctiptors_count_row = input_image.width / DESCRIPTOR_BUFFER_LEN_MAX;
-		input_desctiptors_count = input_image.height * input_desctiptors_count_row;
+__attribute__((target("ssse3")))
+static void replicateRow2Ssse3(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 16 <= input_width; in_col += 16) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(input_row + in_col));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 2), _mm_unpacklo_epi8(pixels, pixels));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 2 + 16), _mm_unpackhi_epi8(pixels, pixels));
 	}
+	replicateRowScalar(input_row, input_width, output_row, 2, in_col);
+}
 
-#if VERBOSE_LEVEL>0
-    printf("Number of input descriptors: %u\n", (unsigned int)input_desctiptors_count);
-#endif
+__attribute__((target("ssse3")))
+static void replicateRow3Ssse3(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	const __m128i mask_0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+	const __m128i mask_1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+	const __m128i mask_2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+	alt_u32 in_col = 0;
+	for (; in_col + 16 <= input_width; in_col += 16) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(input_row + in_col));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 3), _mm_shuffle_epi8(pixels, mask_0));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 3 + 16), _mm_shuffle_epi8(pixels, mask_1));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 3 + 32), _mm_shuffle_epi8(pixels, mask_2));
+	}
+	replicateRowScalar(input_row, input_width, output_row, 3, in_col);
+}
 
-	// checking potential overflow that may occur as a result of addition
-	if ((BIGGEST_32BIT_UNSIGNED_NUMBER - 2) < input_desctiptors_count) {
-		printf("ERROR: While allocating descriptors. Input image is too big.\n");
-		return 1;
+__attribute__((target("ssse3")))
+static void replicateRow4Ssse3(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 16 <= input_width; in_col += 16) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(input_row + in_col));
+		__m128i low = _mm_unpacklo_epi8(pixels, pixels);
+		__m128i high = _mm_unpackhi_epi8(pixels, pixels);
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 4), _mm_unpacklo_epi16(low, low));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 4 + 16), _mm_unpackhi_epi16(low, low));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 4 + 32), _mm_unpacklo_epi16(high, high));
+		_mm_storeu_si128((__m128i*)(output_row + in_col * 4 + 48), _mm_unpackhi_epi16(high, high));
 	}
+	replicateRowScalar(input_row, input_width, output_row, 4, in_col);
+}
 
-	// checking potential overflow that may occur as a result of multiplication
-	if ((BIGGEST_32BIT_UNSIGNED_NUMBER / ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE) < input_desctiptors_count + 2) {
-		printf("ERROR: While allocating descriptors. Input image is too big.\n");
-		return 1;
+__attribute__((target("ssse3")))
+static void decimateRow2Ssse3(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	const __m128i even = _mm_set1_epi16(0x00FF);
+	alt_u32 out_col = 0;
+	for (; (out_col + 16) * 2 <= input_width; out_col += 16) {
+		__m128i pixels_0 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(input_row + out_col * 2)), even);
+		__m128i pixels_1 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(input_row + out_col * 2 + 16)), even);
+		_mm_storeu_si128((__m128i*)(output_row + out_col), _mm_packus_epi16(pixels_0, pixels_1));
 	}
+	decimateRowScalar(input_row, output_row, output_width, 2, out_col);
+}
 
-	temp_ptr = malloc((input_desctiptors_count + 2) * ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE);
-	if(temp_ptr == NULL)
-	{
-		printf("ERROR: Failed to allocate memory for the transmit descriptors\n");
-		return 1;
+__attribute__((target("ssse3")))
+static void decimateRow3Ssse3(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	// output pixels 0-5 come from first, 6-10 from second and 11-15 from third input vector
+	const __m128i mask_0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i mask_1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+	const __m128i mask_2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+	alt_u32 out_col = 0;
+	for (; (out_col + 16) * 3 <= input_width; out_col += 16) {
+		__m128i pixels_0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input_row + out_col * 3)), mask_0);
+		__m128i pixels_1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input_row + out_col * 3 + 16)), mask_1);
+		__m128i pixels_2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input_row + out_col * 3 + 32)), mask_2);
+		_mm_storeu_si128((__m128i*)(output_row + out_col), _mm_or_si128(_mm_or_si128(pixels_0, pixels_1), pixels_2));
 	}
-	*transmit_descriptors_copy_p = (alt_sgdma_descriptor *)temp_ptr;
+	decimateRowScalar(input_row, output_row, output_width, 3, out_col);
+}
 
-	while((((alt_u32)temp_ptr) % ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE) != 0)
-	{
-		temp_ptr++;  // slide the pointer until 32 byte boundary is found
+__attribute__((target("ssse3")))
+static void decimateRow4Ssse3(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	const __m128i first = _mm_set1_epi32(0x000000FF);
+	alt_u32 out_col = 0;
+	for (; (out_col + 16) * 4 <= input_width; out_col += 16) {
+		__m128i pixels_0 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(input_row + out_col * 4)), first);
+		__m128i pixels_1 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(input_row + out_col * 4 + 16)), first);
+		__m128i pixels_2 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(input_row + out_col * 4 + 32)), first);
+		__m128i pixels_3 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(input_row + out_col * 4 + 48)), first);
+		_mm_storeu_si128((__m128i*)(output_row + out_col),
+				_mm_packus_epi16(_mm_packs_epi32(pixels_0, pixels_1), _mm_packs_epi32(pixels_2, pixels_3)));
 	}
+	decimateRowScalar(input_row, output_row, output_width, 4, out_col);
+}
 
-	transmit_descriptors = (alt_sgdma_descriptor *)temp_ptr;
+static const SwRowKernels_t sw_row_kernels_ssse3 = {
+	"ssse3",
+	{ { NULL, copyRow, decimateRow2Ssse3, decimateRow3Ssse3, decimateRow4Ssse3 },
+	  { NULL, copyRow, replicateRow2Ssse3, replicateRow3Ssse3, replicateRow4Ssse3 } }
+};
 
-	*transmit_descriptors_p = transmit_descriptors;
+/*
+	AVX2: same as SSSE3 with 32 pixels at a time. unpack and pack work inside 128 bit lanes,
+	so 64 bit blocks are reordered before unpack and after pack. x3 and /3 stay on SSSE3.
+*/
+__attribute__((target("avx2")))
+static void replicateRow2Avx2(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 32 <= input_width; in_col += 32) {
+		__m256i pixels = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)(input_row + in_col)), 0xD8);
+		_mm256_storeu_si256((__m256i*)(output_row + in_col * 2), _mm256_unpacklo_epi8(pixels, pixels));
+		_mm256_storeu_si256((__m256i*)(output_row + in_col * 2 + 32), _mm256_unpackhi_epi8(pixels, pixels));
+	}
+	replicateRowScalar(input_row, input_width, output_row, 2, in_col);
+}
 
-	/* Clear out the null descriptor owned by hardware bit.  These locations
-	 * came from the heap so we don't know what state the bytes are in (owned bit could be high).*/
-	transmit_descriptors[input_desctiptors_count].control = 0;
+__attribute__((target("avx2")))
+static void replicateRow4Avx2(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 32 <= input_width; in_col += 32) {
+		__m256i pixels = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)(input_row + in_col)), 0xD8);
+		__m256i low = _mm256_permute4x64_epi64(_mm256_unpacklo_epi8(pixels, pixels), 0xD8);
+		__m256i high = _mm256_permute4x64_epi64(_mm256_unpackhi_epi8(pixels, pixels), 0xD8);
+		_mm256_storeu_si256((__m256i*)(output_row + in_col * 4), _mm256_unpacklo_epi16(low, low));
+		_mm256_storeu_si256((__m256i*)(output_row + in_col * 4 + 32), _mm256_unpackhi_epi16(low, low));
+		_mm256_storeu_si256((__m256i*)(output_row + in_col * 4 + 64), _mm256_unpacklo_epi16(high, high));
+		_mm256_storeu_si256((__m256i*)(output_row + in_col * 4 + 96), _mm256_unpackhi_epi16(high, high));
+	}
+	replicateRowScalar(input_row, input_width, output_row, 4, in_col);
+}
 
-	/*
-	   * Allocation of the receive descriptors                    *
-	   * - First allocate a large buffer to the temporary pointer *
-	   * - Second check for successful memory allocation          *
-	   * - Third put this memory location into the pointer copy   *
-	   *   to be freed before the program exits                   *
-	   * - Forth slide the temporary pointer until it lies on a 32*
-	   *   byte boundary (descriptor master is 256 bits wide)     */
+__attribute__((target("avx2")))
+static void decimateRow2Avx2(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	const __m256i even = _mm256_set1_epi16(0x00FF);
+	alt_u32 out_col = 0;
+	for (; (out_col + 32) * 2 <= input_width; out_col += 32) {
+		__m256i pixels_0 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(input_row + out_col * 2)), even);
+		__m256i pixels_1 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(input_row + out_col * 2 + 32)), even);
+		_mm256_storeu_si256((__m256i*)(output_row + out_col),
+				_mm256_permute4x64_epi64(_mm256_packus_epi16(pixels_0, pixels_1), 0xD8));
+	}
+	decimateRowScalar(input_row, output_row, output_width, 2, out_col);
+}
 
-	// calculate number of descriptors for input image
-	// number of rows * number of descriptors per row
-	if (output_image.width % DESCRIPTOR_BUFFER_LEN_MAX) {
-		// checking potential overflow that may occur as a result of multiplication
-		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (output_image.width / DESCRIPTOR_BUFFER_LEN_MAX + 1)) < output_image.height) {
-			printf("ERROR: While allocating descriptors. Input image is too big.\n");
-			return 1;
-		}
-		output_desctiptors_count_row = output_image.width / DESCRIPTOR_BUFFER_LEN_MAX + 1;
-		output_desctiptors_count = output_image.height * output_desctiptors_count_row;
-	} else {
-		// checking potential overflow that may occur as a result of multiplication
-		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (output_image.width / DESCRIPTOR_BUFFER_LEN_MAX)) < output_image.height) {
-			printf("ERROR: While allocating descriptors. Input image is too big.\n");
-			return 1;
-		}
-		output_desctiptors_count_row = output_image.width / DESCRIPTOR_BUFFER_LEN_MAX;
-		output_desctiptors_count = output_image.height * output_desctiptors_count_row;
+__attribute__((target("avx2")))
+static void decimateRow4Avx2(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	const __m256i first = _mm256_set1_epi32(0x000000FF);
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	alt_u32 out_col = 0;
+	for (; (out_col + 32) * 4 <= input_width; out_col += 32) {
+		__m256i pixels_0 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(input_row + out_col * 4)), first);
+		__m256i pixels_1 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(input_row + out_col * 4 + 32)), first);
+		__m256i pixels_2 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(input_row + out_col * 4 + 64)), first);
+		__m256i pixels_3 = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(input_row + out_col * 4 + 96)), first);
+		__m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(pixels_0, pixels_1), _mm256_packs_epi32(pixels_2, pixels_3));
+		_mm256_storeu_si256((__m256i*)(output_row + out_col), _mm256_permutevar8x32_epi32(packed, order));
 	}
+	decimateRowScalar(input_row, output_row, output_width, 4, out_col);
+}
 
-#if VERBOSE_LEVEL>0
-    printf("Number of output descriptors: %u\n", (unsigned int)output_desctiptors_count);
+static const SwRowKernels_t sw_row_kernels_avx2 = {
+	"avx2",
+	{ { NULL, copyRow, decimateRow2Avx2, decimateRow3Ssse3, decimateRow4Avx2 },
+	  { NULL, copyRow, replicateRow2Avx2, replicateRow3Ssse3, replicateRow4Avx2 } }
+};
 #endif
 
-	// checking potential overflow that may occur as a result of addition
-	if ((BIGGEST_32BIT_UNSIGNED_NUMBER - 2) < output_desctiptors_count) {
-		printf("ERROR: While allocating descriptors. Input image is too big.\n");
-		return 1;
+#if HOST_BUILD>0 && defined(__ARM_NEON)
+/*
+	NEON: increase stores same 16 input pixels interleaved 2, 3 or 4 times,
+	decrease loads 16 x scaling_factor pixels deinterleaved and keeps first vector
+*/
+static void replicateRow2Neon(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 16 <= input_width; in_col += 16) {
+		uint8x16_t pixels = vld1q_u8(input_row + in_col);
+		uint8x16x2_t output = { { pixels, pixels } };
+		vst2q_u8(output_row + in_col * 2, output);
 	}
+	replicateRowScalar(input_row, input_width, output_row, 2, in_col);
+}
 
-	// checking potential overflow that may occur as a result of multiplication
-	if ((BIGGEST_32BIT_UNSIGNED_NUMBER / ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE) < output_desctiptors_count + 2) {
-		printf("ERROR: While allocating descriptors. Input image is too big.\n");
-		return 1;
+static void replicateRow3Neon(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 16 <= input_width; in_col += 16) {
+		uint8x16_t pixels = vld1q_u8(input_row + in_col);
+		uint8x16x3_t output = { { pixels, pixels, pixels } };
+		vst3q_u8(output_row + in_col * 3, output);
 	}
+	replicateRowScalar(input_row, input_width, output_row, 3, in_col);
+}
 
-	temp_ptr = malloc((output_desctiptors_count + 2) * ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE);
-	if(temp_ptr == NULL)
-	{
-		printf("ERROR: Failed to allocate memory for the transmit descriptors\n");
-		return 1;
+static void replicateRow4Neon(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	(void)output_width;
+	alt_u32 in_col = 0;
+	for (; in_col + 16 <= input_width; in_col += 16) {
+		uint8x16_t pixels = vld1q_u8(input_row + in_col);
+		uint8x16x4_t output = { { pixels, pixels, pixels, pixels } };
+		vst4q_u8(output_row + in_col * 4, output);
 	}
-	*receive_descriptors_copy_p = (alt_sgdma_descriptor *)temp_ptr;
+	replicateRowScalar(input_row, input_width, output_row, 4, in_col);
+}
 
-	while((((alt_u32)temp_ptr) % ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE) != 0)
-	{
-		temp_ptr++;  // slide the pointer until 32 byte boundary is found
+static void decimateRow2Neon(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	alt_u32 out_col = 0;
+	for (; (out_col + 16) * 2 <= input_width; out_col += 16) {
+		vst1q_u8(output_row + out_col, vld2q_u8(input_row + out_col * 2).val[0]);
 	}
+	decimateRowScalar(input_row, output_row, output_width, 2, out_col);
+}
 
-	receive_descriptors = (alt_sgdma_descriptor *)temp_ptr;
-	*receive_descriptors_p = receive_descriptors;
+static void decimateRow3Neon(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	alt_u32 out_col = 0;
+	for (; (out_col + 16) * 3 <= input_width; out_col += 16) {
+		vst1q_u8(output_row + out_col, vld3q_u8(input_row + out_col * 3).val[0]);
+	}
+	decimateRowScalar(input_row, output_row, output_width, 3, out_col);
+}
 
-	/* Clear out the null descriptor owned by hardware bit.  These locations
-	 * came from the heap so we don't know what state the bytes are in (owned bit could be high).*/
-	receive_descriptors[output_desctiptors_count].control = 0;
+static void decimateRow4Neon(const alt_u8 *input_row, alt_u32 input_width, alt_u8 *output_row, alt_u32 output_width) {
+	alt_u32 out_col = 0;
+	for (; (out_col + 16) * 4 <= input_width; out_col += 16) {
+		vst1q_u8(output_row + out_col, vld4q_u8(input_row + out_col * 4).val[0]);
+	}
+	decimateRowScalar(input_row, output_row, output_width, 4, out_col);
+}
 
-	// fill allocated memory with transmit descriptor data
-	current_descriptor = 0;
-	for (alt_u32 i = 0; i < input_image.height; i++) {
-		for (alt_u32 j = 0; j < input_desctiptors_count_row; j++) {
-			// current descriptor
-			// number of bytes to send
-			alt_u32 buffer_length;
-			if (j < input_desctiptors_count_row-1) {
-				// not last buffer in this row
-				buffer_length = DESCRIPTOR_BUFFER_LEN_MAX;
-			} else {
-				// last buffer in this row
-				buffer_length = input_image.width-j*DESCRIPTOR_BUFFER_LEN_MAX;
-			}
+static const SwRowKernels_t sw_row_kernels_neon = {
+	"neon",
+	{ { NULL, copyRow, decimateRow2Neon, decimateRow3Neon, decimateRow4Neon },
+	  { NULL, copyRow, replicateRow2Neon, replicateRow3Neon, replicateRow4Neon } }
+};
+#endif
 
-			/* This will create a descriptor that is capable of transmitting data from an Avalon-MM buffer
-			 * to a packet enabled Avalon-ST FIFO component */
-			alt_avalon_sgdma_construct_mem_to_stream_desc(
-					&transmit_descriptors[current_descriptor],  							// current descriptor pointer
-					&transmit_descriptors[current_descriptor+1], 							// next descriptor pointer
-					(alt_u32*)&(input_image.pixels)[i][j*DESCRIPTOR_BUFFER_LEN_MAX],	// read buffer location
-					(alt_u16)buffer_length,  								// length of the buffer
-					0, 		// reads are not from a fixed location
-					0,		// start of packet is disabled for the Avalon-ST interfaces
-					0, 		// end of packet is disabled for the Avalon-ST interfaces,
-					0);  	// there is only one channel
-			current_descriptor++;
+// best kernel set supported by cpu, checked on first use
+static const SwRowKernels_t *swRowKernels() {
+	static const SwRowKernels_t *kernels = NULL;
+
+	if (kernels == NULL) {
+		kernels = &sw_row_kernels_scalar;
+#if HOST_BUILD>0 && HOST_SW_SIMD>0
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			kernels = &sw_row_kernels_avx2;
+		} else if (__builtin_cpu_supports("ssse3")) {
+			kernels = &sw_row_kernels_ssse3;
 		}
+#elif defined(__ARM_NEON)
+		kernels = &sw_row_kernels_neon;
+#endif
+#endif
 	}
+	return kernels;
+}
 
-	// fill allocated memory with receive descriptor data
-	current_descriptor = 0;
-	for (alt_u32 i = 0; i < output_image.height; i++) {
-		for (alt_u32 j = 0; j < output_desctiptors_count_row; j++) {
-			// number of bytes to send
-			alt_u32 buffer_length;
-			if (j < output_desctiptors_count_row-1) {
-				// not last buffer in this row
-				buffer_length = DESCRIPTOR_BUFFER_LEN_MAX;
+SwRowKernel_t swSelectRowKernel(ScalingFactor_t scaling_factor, IncreaseDecreaseResolution_t increase_decrease) {
+	const SwRowKernels_t *kernels = swRowKernels();
+	return kernels->kernels[increase_decrease][scaling_factor];
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	does acc_scale to rows [first_row, last_row) of output image
+
+	same result as swProcessImageReference, but input pixel is computed directly from output pixel
+	(increase: [row/scaling_factor, col/scaling_factor], decrease: [row*scaling_factor,
+	col*scaling_factor]), so any band of output rows can be processed on its own.
+	row_kernel is the one returned by swSelectRowKernel for the same scaling.
+	------------------------------------------------------------------------------------------------
+*/
+void swProcessRows(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image,
+        alt_u32 first_row,
+        alt_u32 last_row,
+        SwRowKernel_t row_kernel) {
+
+	for (alt_u32 out_row = first_row; out_row < last_row; out_row++) {
+		alt_u8 *output_row = output_image.pixels + out_row * output_image.stride;
+
+		if (increase_decrease == INCREASE) {
+			if ((out_row % scaling_factor) != 0 && out_row > first_row) {
+				// same input row as previous output row
+				memcpy(output_row, output_row - output_image.stride, output_image.width);
 			} else {
-				// last buffer in this row
-				buffer_length = output_image.width-j*DESCRIPTOR_BUFFER_LEN_MAX;
+				alt_u8 *input_row = input_image.pixels + (out_row / scaling_factor) * input_image.stride;
+				row_kernel(input_row, input_image.width, output_row, output_image.width);
 			}
+		} else {
+			alt_u8 *input_row = input_image.pixels + out_row * scaling_factor * input_image.stride;
+			row_kernel(input_row, input_image.width, output_row, output_image.width);
+		}
+	}
+}
 
-			/* This will create a descriptor that is capable of transmitting data from an Avalon-MM buffer
-			 * to a packet enabled Avalon-ST FIFO component */
-			alt_avalon_sgdma_construct_stream_to_mem_desc(
-					&receive_descriptors[current_descriptor],  							// current descriptor pointer
-					&receive_descriptors[current_descriptor+1], 							// next descriptor pointer
-					(alt_u32*)&(output_image.pixels)[i][j*DESCRIPTOR_BUFFER_LEN_MAX],	// write buffer location
-					(alt_u16)buffer_length,  								// length of the buffer
-					0); // writes are not to a fixed location
-			current_descriptor++;
+/*
+	------------------------------------------------------------------------------------------------
+	does acc_scale to image in tiles of input image
+
+	tile of tile_width x tile_height input pixels is read while it is in data cache and whole
+	output of the tile is written before next tile is started (increase: tile_width*scaling_factor
+	x tile_height*scaling_factor output pixels, decrease: every scaling_factor-th pixel of tile).
+	for decrease tile sizes are rounded up to multiple of scaling_factor, so every tile starts
+	at pixel which is taken to output. tile_width or tile_height 0 means whole image width/height.
+	same result as swProcessImage.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 swProcessImageTiled(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image,
+        alt_u32 tile_width,
+        alt_u32 tile_height) {
+
+	SwRowKernel_t row_kernel = swSelectRowKernel(scaling_factor, increase_decrease);
+
+	if (tile_width == 0 || tile_width > input_image.width) {
+		tile_width = input_image.width;
+	}
+	if (tile_height == 0 || tile_height > input_image.height) {
+		tile_height = input_image.height;
+	}
+	if (increase_decrease == DECREASE) {
+		tile_width = (tile_width + scaling_factor - 1) / scaling_factor * scaling_factor;
+		tile_height = (tile_height + scaling_factor - 1) / scaling_factor * scaling_factor;
+	}
+
+	for (alt_u32 tile_row = 0; tile_row < input_image.height; tile_row += tile_height) {
+		alt_u32 last_row = (tile_row + tile_height < input_image.height) ? tile_row + tile_height : input_image.height;
+
+		for (alt_u32 tile_col = 0; tile_col < input_image.width; tile_col += tile_width) {
+			alt_u32 cols = (tile_col + tile_width < input_image.width) ? tile_width : input_image.width - tile_col;
+
+			for (alt_u32 in_row = tile_row; in_row < last_row; in_row++) {
+				const alt_u8 *input_row = input_image.pixels + in_row * input_image.stride + tile_col;
+
+				if (increase_decrease == INCREASE) {
+					alt_u8 *output_row = output_image.pixels + in_row * scaling_factor * output_image.stride + tile_col * scaling_factor;
+					row_kernel(input_row, cols, output_row, cols * scaling_factor);
+					// other output rows of the same input row
+					for (alt_u32 k = 1; k < scaling_factor; k++) {
+						memcpy(output_row + k * output_image.stride, output_row, cols * scaling_factor);
+					}
+				} else if ((in_row % scaling_factor) == 0) {
+					alt_u8 *output_row = output_image.pixels + (in_row / scaling_factor) * output_image.stride + tile_col / scaling_factor;
+					row_kernel(input_row, cols, output_row, (cols + scaling_factor - 1) / scaling_factor);
+				}
+			}
 		}
 	}
 
 #if VERBOSE_LEVEL>0
-    printf("createDescriptors end\n");
+    printf("swProcessImageTiled end.\n");
 #endif
-	return 0;  // no failures in allocation
+	return 0;
 }
 
-
 /*
 	------------------------------------------------------------------------------------------------
-	does acc_scale to image utilising hw accelerator
+	does acc_scale to image utilising NIOS processor
 
 	process: input image ---> output image
 	------------------------------------------------------------------------------------------------
 */
-alt_u32 hwProcessImage(
-		alt_sgdma_dev * transmit_DMA,
-		alt_sgdma_descriptor * transmit_descriptors,
-		volatile alt_u16 * tx_done_p,
-		alt_sgdma_dev * receive_DMA,
-		alt_sgdma_descriptor * receive_descriptors,
-		volatile alt_u16 * rx_done_p,
-		ScalingFactor_t scaling_factor,
-		IncreaseDecreaseResolution_t increase_decrease,
-		Image_t input_image) {
-
-	// Configure acc_scale module.
-#if VERBOSE_LEVEL>0
+alt_u32 swProcessImage(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image) {
+
+#if SW_TILE_WIDTH>0 || SW_TILE_HEIGHT>0
+	swProcessImageTiled(scaling_factor, increase_decrease, input_image, output_image, SW_TILE_WIDTH, SW_TILE_HEIGHT);
+#else
+	swProcessRows(scaling_factor, increase_decrease, input_image, output_image, 0, output_image.height,
+			swSelectRowKernel(scaling_factor, increase_decrease));
+#endif
+
+#if VERBOSE_LEVEL>0
+    printf("swProcessImage end.\n");
+#endif
+    return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	point operation of every pixel
+
+	point operation is given as table of 256 results, one for every pixel value. scaling only
+	copies pixels, so point operation done on output image gives the same result as point
+	operation on input image followed by scaling (what the fused hw pipeline does), and output
+	image is never bigger than needed on decrease.
+	------------------------------------------------------------------------------------------------
+*/
+
+// table of point operation acc_scale input goes through in hw (see hwSetPointOperation),
+// expected hw results are computed with it
+static alt_u8 hw_point_table[256];
+
+void pointOperationTable(const PointOperation_t *point_operation, alt_u8 *table) {
+	for (alt_u32 x = 0; x < 256; x++) {
+		alt_32 y;
+
+		switch (point_operation->type) {
+		case POINT_LINEAR:
+			// low byte of a*x+b is the same whether pixel is taken as signed (as in hw) or unsigned
+			table[x] = (alt_u8)(point_operation->a * (alt_32)x + point_operation->b);
+			break;
+		case POINT_SATURATE:
+			y = point_operation->a * (alt_32)x + point_operation->b;
+			table[x] = (y < 0) ? 0 : ((y > 255) ? 255 : (alt_u8)y);
+			break;
+		case POINT_LUT:
+			table[x] = point_operation->lut[x];
+			break;
+		default:
+			table[x] = (alt_u8)x;
+			break;
+		}
+	}
+}
+
+// point operation of rows [first_row, last_row) of image, in place
+void swPointOperationRows(const alt_u8 *table, Image_t image, alt_u32 first_row, alt_u32 last_row) {
+	for (alt_u32 row = first_row; row < last_row; row++) {
+		alt_u8 *pixels = image.pixels + row * image.stride;
+		for (alt_u32 col = 0; col < image.width; col++) {
+			pixels[col] = table[pixels[col]];
+		}
+	}
+}
+
+void swPointOperationImage(const PointOperation_t *point_operation, Image_t image) {
+	alt_u8 table[256];
+
+	if (point_operation->type == POINT_NONE) {
+		return;
+	}
+	pointOperationTable(point_operation, table);
+	swPointOperationRows(table, image, 0, image.height);
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	parses point operation given as text (batch manifest field or user input)
+
+	formats:
+		linear={a},{b}		y = a*x + b, low byte of y (a and b in range [-128,127])
+		saturate={a},{b}	y = a*x + b saturated to [0,255] (a and b in range [-128,127])
+		gamma={g}			y = 255 * (x/255)^g (g in range (0,POINT_GAMMA_MAX])
+		threshold={t}		y = 255 if x >= t, otherwise 0 (t in range [0,255])
+		lut={filename}		y = lut[x], lut is file of 256 bytes in INPUT_DIRECTORY
+	gamma, threshold and lut are done by LUT mode of acc_linear_function
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 loadPointTable(char *filename, alt_u8 *lut) {
+	FILE *ptr_file;
+	alt_8 path[PATH_MAX_LEN];
+
+	if (strlen(filename) + sizeof(INPUT_DIRECTORY) > PATH_MAX_LEN) {
+		printf("ERROR: LUT filename \"%s\" is too long\n", filename);
+		return 1;
+	}
+	strcpy((char*)path, INPUT_DIRECTORY);
+	strcat((char*)path, filename);
+
+	ptr_file = fopen((char*)path, "rb");
+	if (ptr_file == NULL) {
+		printf("ERROR: Unable to open file \"%s\"!\n", filename);
+		return 1;
+	}
+	if (readBlock(ptr_file, lut, 256)) {
+		printf("ERROR: LUT file \"%s\" must have 256 bytes\n", filename);
+		fclose(ptr_file);
+		return 1;
+	}
+	fclose(ptr_file);
+	return 0;
+}
+
+alt_u32 parsePointOperation(char *token, PointOperation_t *point_operation) {
+	char *end;
+
+	if (strncmp(token, "linear=", 7) == 0 || strncmp(token, "saturate=", 9) == 0) {
+		char *value = strchr(token, '=') + 1;
+		long a;
+		long b;
+
+		a = strtol(value, &end, 10);
+		if (end == value || *end != ',') {
+			printf("ERROR: Point operation must be %s{a},{b}\n", (token[0] == 'l') ? "linear=" : "saturate=");
+			return 1;
+		}
+		value = end + 1;
+		b = strtol(value, &end, 10);
+		if (end == value || *end != '\0') {
+			printf("ERROR: Point operation must be %s{a},{b}\n", (token[0] == 'l') ? "linear=" : "saturate=");
+			return 1;
+		}
+		if (a < -128 || a > 127 || b < -128 || b > 127) {
+			printf("ERROR: a and b must be numbers in range [-128,127]\n");
+			return 1;
+		}
+		point_operation->type = (token[0] == 'l') ? POINT_LINEAR : POINT_SATURATE;
+		point_operation->a = (alt_8)a;
+		point_operation->b = (alt_8)b;
+	} else if (strncmp(token, "gamma=", 6) == 0) {
+		double gamma = strtod(token + 6, &end);
+		if (end == token + 6 || *end != '\0' || !(gamma > 0.0 && gamma <= POINT_GAMMA_MAX)) {
+			printf("ERROR: Gamma must be a number in range (0,%d]\n", POINT_GAMMA_MAX);
+			return 1;
+		}
+		point_operation->type = POINT_LUT;
+		for (alt_u32 x = 0; x < 256; x++) {
+			point_operation->lut[x] = (alt_u8)(255.0 * pow(x / 255.0, gamma) + 0.5);
+		}
+	} else if (strncmp(token, "threshold=", 10) == 0) {
+		unsigned long threshold = strtoul(token + 10, &end, 10);
+		if (end == token + 10 || *end != '\0' || threshold > 255) {
+			printf("ERROR: Threshold must be a number in range [0,255]\n");
+			return 1;
+		}
+		point_operation->type = POINT_LUT;
+		for (alt_u32 x = 0; x < 256; x++) {
+			point_operation->lut[x] = (x >= threshold) ? 255 : 0;
+		}
+	} else if (strncmp(token, "lut=", 4) == 0) {
+		if (loadPointTable(token + 4, point_operation->lut)) {
+			return 1;
+		}
+		point_operation->type = POINT_LUT;
+	} else {
+		printf("ERROR: Point operation must be linear={a},{b}, saturate={a},{b}, gamma={g}, threshold={t} or lut={filename}\n");
+		return 1;
+	}
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	parses user input
+
+	parse user inputted: point operation done on every pixel before scaling (see parsePointOperation)
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 pointOperationUserInput(PointOperation_t* point_operation) {
+    char line[BATCH_FILENAME_MAX_LEN + 16];
+
+    printf("{none/point operation}\n");
+    printf("   0/linear={a},{b} saturate={a},{b} gamma={g} threshold={t} lut={filename}\n");
+
+    if (fgets(line, sizeof(line), stdin) == NULL) {
+        return 1;
+    }
+    if (strchr(line, '\n') == NULL) {
+        printf("ERROR: Point operation exceeded maximum alowed lenght of %d characters\n", (int)sizeof(line) - 2);
+        while(getchar() != '\n');
+        return 1;
+    }
+    line[strcspn(line, " \r\n")] = '\0';
+
+    point_operation->type = POINT_NONE;
+    if (strcmp(line, "0") != 0 && parsePointOperation(line, point_operation)) {
+        return 1;
+    }
+
+    printf("User inputted: %s\n", line);
+    return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	does point operation and acc_scale to image utilising NIOS processor
+
+	sw reference of the fused pipeline sgdma -> acc_linear_function -> acc_scale -> sgdma
+
+	process: input image ---> output image
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 swPointProcessImage(
+        const PointOperation_t *point_operation,
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image) {
+
+	if (swProcessImage(scaling_factor, increase_decrease, input_image, output_image)) {
+		return 1;
+	}
+	swPointOperationImage(point_operation, output_image);
+
+#if VERBOSE_LEVEL>0
+    printf("swPointProcessImage end.\n");
+#endif
+    return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	resizes image to any size by nearest neighbour, used as residual step of fit to box jobs
+
+	output pixel [row,col] is input pixel [row * input height / output height, col * input width /
+	output width], so exact decrease by scaling factor takes the same pixels as acc_scale
+	------------------------------------------------------------------------------------------------
+*/
+void swResizeImage(Image_t input_image, Image_t output_image) {
+	for (alt_u32 row = 0; row < output_image.height; row++) {
+		alt_u32 input_row = (alt_u32)((alt_u64)row * input_image.height / output_image.height);
+		alt_u8 *input_pixels = input_image.pixels + input_row * input_image.stride;
+		alt_u8 *output_pixels = output_image.pixels + row * output_image.stride;
+		alt_u32 input_col = 0;
+		alt_u32 remainder = 0;
+
+		// input_col = col * input width / output width, kept without division
+		for (alt_u32 col = 0; col < output_image.width; col++) {
+			output_pixels[col] = input_pixels[input_col];
+			input_col += input_image.width / output_image.width;
+			remainder += input_image.width % output_image.width;
+			if (remainder >= output_image.width) {
+				remainder -= output_image.width;
+				input_col++;
+			}
+		}
+	}
+#if VERBOSE_LEVEL>0
+    printf("swResizeImage end.\n");
+#endif
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	makes image pyramid in one walk over input image
+
+	level k (levels[k-1]) is the same as decrease with scaling factor 2^k. only input rows that
+	are multiple of 2 are read, every one of them once for all the levels that keep it.
+	------------------------------------------------------------------------------------------------
+*/
+void swPyramidImage(Image_t input_image, Image_t *levels, alt_u32 levels_count) {
+	for (alt_u32 row = 0; row < input_image.height; row += 2) {
+		alt_u8 *input_pixels = input_image.pixels + row * input_image.stride;
+
+		// row that is not multiple of 2^k is not multiple of 2^(k+1) either
+		for (alt_u32 level = 0; level < levels_count && (row & ((2u << level) - 1)) == 0; level++) {
+			alt_u32 step = 2u << level;
+			alt_u8 *output_pixels = levels[level].pixels + (row >> (level + 1)) * levels[level].stride;
+
+			for (alt_u32 col = 0, i = 0; col < input_image.width; col += step, i++) {
+				output_pixels[i] = input_pixels[col];
+			}
+		}
+	}
+#if VERBOSE_LEVEL>0
+    printf("swPyramidImage end.\n");
+#endif
+}
+
+#if HOST_BUILD>0
+/*
+	------------------------------------------------------------------------------------------------
+	thread pool of software scaling (host build only)
+
+	output image is split into as many row bands as there are threads. calling thread processes
+	bands too, so pool has one thread less than number of threads. bands are taken from shared
+	counter, pool threads sleep between tasks.
+	------------------------------------------------------------------------------------------------
+*/
+typedef struct {
+	pthread_t threads[HOST_SW_THREADS_MAX];
+	alt_u32 threads_count;		// threads of pool, without calling thread
+	pthread_mutex_t lock;
+	pthread_cond_t task_ready;
+	pthread_cond_t task_done;
+	alt_u32 generation;			// incremented for every new task
+	alt_u32 stopping;
+	// current task
+	ScalingFactor_t scaling_factor;
+	IncreaseDecreaseResolution_t increase_decrease;
+	Image_t input_image;
+	Image_t output_image;
+	SwRowKernel_t row_kernel;
+	alt_u32 bands;
+	alt_u32 next_band;
+	alt_u32 bands_left;
+} SwThreadPool_t;
+
+static SwThreadPool_t sw_pool = { .lock = PTHREAD_MUTEX_INITIALIZER, .task_ready = PTHREAD_COND_INITIALIZER, .task_done = PTHREAD_COND_INITIALIZER };
+
+// takes and processes bands until none is left, called with lock held
+static void swPoolProcessBands(SwThreadPool_t *pool) {
+	while (pool->next_band < pool->bands) {
+		alt_u32 band = pool->next_band++;
+		alt_u32 first_row = (alt_u32)((alt_u64)band * pool->output_image.height / pool->bands);
+		alt_u32 last_row = (alt_u32)((alt_u64)(band + 1) * pool->output_image.height / pool->bands);
+
+		pthread_mutex_unlock(&pool->lock);
+		swProcessRows(pool->scaling_factor, pool->increase_decrease, pool->input_image, pool->output_image, first_row, last_row, pool->row_kernel);
+		pthread_mutex_lock(&pool->lock);
+
+		pool->bands_left--;
+		if (pool->bands_left == 0) {
+			pthread_cond_broadcast(&pool->task_done);
+		}
+	}
+}
+
+static void *swPoolThread(void *context) {
+	SwThreadPool_t *pool = (SwThreadPool_t*)context;
+	alt_u32 generation = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	while (1) {
+		while (pool->generation == generation && !pool->stopping) {
+			pthread_cond_wait(&pool->task_ready, &pool->lock);
+		}
+		if (pool->stopping) {
+			break;
+		}
+		generation = pool->generation;
+		swPoolProcessBands(pool);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+void swPoolStop() {
+	pthread_mutex_lock(&sw_pool.lock);
+	sw_pool.stopping = 1;
+	pthread_cond_broadcast(&sw_pool.task_ready);
+	pthread_mutex_unlock(&sw_pool.lock);
+
+	for (alt_u32 i = 0; i < sw_pool.threads_count; i++) {
+		pthread_join(sw_pool.threads[i], NULL);
+	}
+	sw_pool.threads_count = 0;
+	sw_pool.stopping = 0;
+}
+
+// makes sure pool has exactly threads_count threads
+alt_u32 swPoolStart(alt_u32 threads_count) {
+	if (threads_count == sw_pool.threads_count) {
+		return 0;
+	}
+	swPoolStop();
+
+	// threads start waiting for the next task
+	for (alt_u32 i = 0; i < threads_count; i++) {
+		if (pthread_create(&sw_pool.threads[i], NULL, swPoolThread, &sw_pool) != 0) {
+			printf("ERROR: Unable to start software scaling thread.\n");
+			return 1;
+		}
+		sw_pool.threads_count++;
+	}
+	return 0;
+}
+
+// number of threads used when HOST_SW_THREADS is 0
+alt_u32 hostCoresCount() {
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cores < 1) {
+		return 1;
+	}
+	return (cores > HOST_SW_THREADS_MAX) ? HOST_SW_THREADS_MAX : (alt_u32)cores;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	does acc_scale to image utilising threads_count threads (host build only)
+
+	same result as swProcessImage, output rows are split into threads_count bands, row kernel is selected once for the image
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 swProcessImageParallel(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image,
+        alt_u32 threads_count) {
+
+	if (threads_count == 0) {
+		threads_count = (HOST_SW_THREADS > 0) ? HOST_SW_THREADS : hostCoresCount();
+	}
+	if (threads_count > HOST_SW_THREADS_MAX) {
+		threads_count = HOST_SW_THREADS_MAX;
+	}
+	// band needs at least one row
+	if (threads_count > output_image.height) {
+		threads_count = (output_image.height > 0) ? output_image.height : 1;
+	}
+
+	SwRowKernel_t row_kernel = swSelectRowKernel(scaling_factor, increase_decrease);
+
+	if (threads_count == 1) {
+		swProcessRows(scaling_factor, increase_decrease, input_image, output_image, 0, output_image.height, row_kernel);
+		return 0;
+	}
+	if (swPoolStart(threads_count - 1)) {
+		return 1;
+	}
+
+	pthread_mutex_lock(&sw_pool.lock);
+	sw_pool.scaling_factor = scaling_factor;
+	sw_pool.increase_decrease = increase_decrease;
+	sw_pool.input_image = input_image;
+	sw_pool.output_image = output_image;
+	sw_pool.row_kernel = row_kernel;
+	sw_pool.bands = threads_count;
+	sw_pool.next_band = 0;
+	sw_pool.bands_left = threads_count;
+	sw_pool.generation++;
+	pthread_cond_broadcast(&sw_pool.task_ready);
+
+	// calling thread works on bands too, then waits for the rest
+	swPoolProcessBands(&sw_pool);
+	while (sw_pool.bands_left > 0) {
+		pthread_cond_wait(&sw_pool.task_done, &sw_pool.lock);
+	}
+	pthread_mutex_unlock(&sw_pool.lock);
+
+#if VERBOSE_LEVEL>0
+    printf("swProcessImageParallel end, %u threads.\n", (unsigned int)threads_count);
+#endif
+	return 0;
+}
+#endif
+
+/*
+	------------------------------------------------------------------------------------------------
+	stores output image pixel values in bin output file
+
+	write output image width, height and pixels to binary file
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 storeImage(alt_8 *filename, Image_t image) {
+    FILE *ptr_output_file;
+    alt_u32 result = 0;
+
+    // open output file
+    ptr_output_file = fopen((char*)filename,"wb");
+    if (ptr_output_file == NULL)
+    {
+        printf("Unable to open file \"%s\"!\n", filename);
+        return 1;
+    }
+
+    // write image width and height
+    fwrite(&(image.width),sizeof(image.width),1,ptr_output_file);
+	fwrite(&(image.height),sizeof(image.height),1,ptr_output_file);
+
+    // write all the pixels, packed image as one block and view of image row by row
+	if (image.stride == image.width) {
+		result = writeBlock(ptr_output_file, image.pixels, (alt_u64)image.width * image.height * sizeof(alt_u8));
+	} else {
+		for (alt_u32 i = 0; i < image.height && result == 0; i++) {
+			result = writeBlock(ptr_output_file, image.pixels + i * image.stride, image.width * sizeof(alt_u8));
+		}
+	}
+    if (result) {
+        printf("ERROR: Unable to write file \"%s\"!\n", filename);
+    }
+
+    // close output file
+    fclose(ptr_output_file);
+
+#if VERBOSE_LEVEL>0
+    printf("storeImage end.\n");
+#endif
+    return result;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	checks if filename has tiled image extension
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 isTiledImage(alt_8 *filename) {
+	alt_u32 filename_len = strlen((char*)filename);
+	alt_u32 extension_len = strlen(TILED_IMAGE_EXTENSION);
+
+	return (filename_len > extension_len) && (strcmp((char*)filename + filename_len - extension_len, TILED_IMAGE_EXTENSION) == 0);
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	run length encodes tile pixels (PackBits)
+
+	control byte c < 128 is followed by c+1 literal bytes, control byte c > 128 is followed by one
+	byte that is repeated 257-c times. returns encoded size or 0 if it does not fit into capacity.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 rleEncode(alt_u8 *source, alt_u32 size, alt_u8 *destination, alt_u32 capacity) {
+	alt_u32 in = 0;
+	alt_u32 out = 0;
+
+	while (in < size) {
+		alt_u32 run = 1;
+		while (in + run < size && run < 128 && source[in + run] == source[in]) {
+			run++;
+		}
+
+		if (run >= 3) {
+			// repeated byte
+			if (out + 2 > capacity) {
+				return 0;
+			}
+			destination[out++] = (alt_u8)(257 - run);
+			destination[out++] = source[in];
+			in += run;
+		} else {
+			// literal bytes until next run of at least 3 equal bytes
+			alt_u32 literal = 0;
+			while (in + literal < size && literal < 128) {
+				if (in + literal + 2 < size &&
+					source[in + literal] == source[in + literal + 1] &&
+					source[in + literal] == source[in + literal + 2]) {
+					break;
+				}
+				literal++;
+			}
+			if (out + 1 + literal > capacity) {
+				return 0;
+			}
+			destination[out++] = (alt_u8)(literal - 1);
+			memcpy(destination + out, source + in, literal);
+			out += literal;
+			in += literal;
+		}
+	}
+	return out;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	decodes run length encoded tile pixels
+
+	fails if encoded data does not decode to exactly size bytes
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 rleDecode(alt_u8 *source, alt_u32 source_size, alt_u8 *destination, alt_u32 size) {
+	alt_u32 in = 0;
+	alt_u32 out = 0;
+
+	while (in < source_size) {
+		alt_u32 control = source[in++];
+		if (control < 128) {
+			alt_u32 literal = control + 1;
+			if (in + literal > source_size || out + literal > size) {
+				return 1;
+			}
+			memcpy(destination + out, source + in, literal);
+			in += literal;
+			out += literal;
+		} else if (control > 128) {
+			alt_u32 run = 257 - control;
+			if (in >= source_size || out + run > size) {
+				return 1;
+			}
+			memset(destination + out, source[in++], run);
+			out += run;
+		}
+	}
+	return (out != size);
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	stores image to tiled image file
+
+	file layout: header, index of all tiles (row by row), tiles. every tile is stored run length
+	encoded if that makes it smaller, raw otherwise. index of a tile row is written once all of its
+	tiles are written, so only one tile row of index is kept in memory.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 storeTiledImage(alt_8 *filename, Image_t image, ReusableBuffer_t *tiles_buffer) {
+	FILE *ptr_output_file;
+	TiledImageHeader_t header;
+	TileIndexEntry_t *index;
+	alt_u8 *raw_tile;
+	alt_u8 *compressed_tile;
+	alt_u32 tile_size = TILED_IMAGE_TILE_SIZE;
+	alt_u32 tiles_x = (image.width + tile_size - 1) / tile_size;
+	alt_u32 tiles_y = (image.height + tile_size - 1) / tile_size;
+	alt_u64 offset;
+	alt_u32 result;
+
+	// checking potential overflow of 32bit file offsets
+	offset = sizeof(header) + (alt_u64)tiles_x * tiles_y * sizeof(TileIndexEntry_t);
+	if (offset + (alt_u64)image.width * image.height > BIGGEST_32BIT_UNSIGNED_NUMBER) {
+		printf("ERROR: Tiled image file would exceed 4GB.\n");
+		return 1;
+	}
+
+	// raw tile, compressed tile and index of one tile row
+	if (reserveBuffer(tiles_buffer, 2 * tile_size * tile_size + tiles_x * sizeof(TileIndexEntry_t))) {
+		return 1;
+	}
+	raw_tile = (alt_u8*)tiles_buffer->memory;
+	compressed_tile = raw_tile + tile_size * tile_size;
+	index = (TileIndexEntry_t*)(compressed_tile + tile_size * tile_size);
+
+    // open output file
+    ptr_output_file = fopen((char*)filename,"wb");
+    if (ptr_output_file == NULL)
+    {
+        printf("Unable to open file \"%s\"!\n", filename);
+        return 1;
+    }
+
+	// write header and empty index
+	header.magic = TILED_IMAGE_MAGIC;
+	header.width = image.width;
+	header.height = image.height;
+	header.tile_size = tile_size;
+	header.compression = TILED_IMAGE_COMPRESSION;
+	result = writeBlock(ptr_output_file, &header, sizeof(header));
+
+	memset(index, 0, tiles_x * sizeof(TileIndexEntry_t));
+	for (alt_u32 ty = 0; ty < tiles_y && result == 0; ty++) {
+		result = writeBlock(ptr_output_file, index, tiles_x * sizeof(TileIndexEntry_t));
+	}
+
+	// write tiles
+	for (alt_u32 ty = 0; ty < tiles_y && result == 0; ty++) {
+		alt_u32 y0 = ty * tile_size;
+		alt_u32 tile_height = (image.height - y0 < tile_size) ? image.height - y0 : tile_size;
+
+		for (alt_u32 tx = 0; tx < tiles_x && result == 0; tx++) {
+			alt_u32 x0 = tx * tile_size;
+			alt_u32 tile_width = (image.width - x0 < tile_size) ? image.width - x0 : tile_size;
+			alt_u32 tile_pixels = tile_width * tile_height;
+			alt_u32 compressed_size = 0;
+
+			for (alt_u32 i = 0; i < tile_height; i++) {
+				memcpy(raw_tile + i * tile_width, image.pixels + (y0 + i) * image.stride + x0, tile_width);
+			}
+
+			if (header.compression == TILE_RLE) {
+				// encoded tile is used only if it is smaller than raw one
+				compressed_size = rleEncode(raw_tile, tile_pixels, compressed_tile, tile_pixels - 1);
+			}
+
+			index[tx].offset = (alt_u32)offset;
+			if (compressed_size > 0) {
+				index[tx].size = compressed_size;
+				result = writeBlock(ptr_output_file, compressed_tile, compressed_size);
+			} else {
+				index[tx].size = tile_pixels;
+				result = writeBlock(ptr_output_file, raw_tile, tile_pixels);
+			}
+			offset += index[tx].size;
+		}
+
+		// fill in index of this tile row
+		if (result == 0) {
+			result = fseek(ptr_output_file, sizeof(header) + ty * tiles_x * sizeof(TileIndexEntry_t), SEEK_SET) != 0 ||
+					 writeBlock(ptr_output_file, index, tiles_x * sizeof(TileIndexEntry_t)) ||
+					 fseek(ptr_output_file, (long)offset, SEEK_SET) != 0;
+		}
+	}
+
+    // close output file, buffered data is written by fclose
+    if (fclose(ptr_output_file) != 0) {
+        result = 1;
+    }
+    if (result) {
+        printf("ERROR: Unable to write file \"%s\"!\n", filename);
+        return 1;
+    }
+
+#if VERBOSE_LEVEL>0
+    printf("storeTiledImage end, %u bytes.\n", (unsigned int)offset);
+#endif
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	reads part of image (or whole image) from tiled image file
+
+	only index entries and tiles that overlap part of image are read. tiles in a tile row are stored
+	one after another, so overlapping tiles of a tile row are read with one read call (in groups of
+	TILED_IMAGE_READ_TILES). input image holds only part of image, packed.
+	------------------------------------------------------------------------------------------------
+*/
+#define TILED_IMAGE_READ_TILES 32
+
+alt_u32 loadTiledImage(
+		alt_8 *input_filename,
+		ImagePartParameters_t image_part_parameters,
+		Image_t *input_image,
+		ReusableBuffer_t *buffer,
+		ReusableBuffer_t *tiles_buffer) {
+
+    FILE *ptr_input_file;
+	TiledImageHeader_t header;
+	TileIndexEntry_t index[TILED_IMAGE_READ_TILES];
+	alt_8 input_filename_nios[PATH_MAX_LEN];
+	alt_u32 row, col;
+	alt_u32 tiles_x;
+	alt_u32 tx_first, tx_last, ty_first, ty_last;
+
+    if (strlen((char*)input_filename) + sizeof(INPUT_DIRECTORY) > PATH_MAX_LEN) {
+        printf("ERROR: Input filename \"%s\" is too long\n", input_filename);
+        return 1;
+    }
+    strcpy((char*)input_filename_nios, INPUT_DIRECTORY);
+    strcat((char*)input_filename_nios, (char*)input_filename);
+
+    // open input file
+    ptr_input_file = fopen((char *)input_filename_nios, "rb");
+    if (ptr_input_file == NULL)
+    {
+        printf("ERROR: Unable to open file \"%s\"!\n", input_filename);
+        return 1;
+    }
+
+	if (fread(&header, sizeof(header), 1, ptr_input_file) != 1 || header.magic != TILED_IMAGE_MAGIC ||
+		header.tile_size == 0 || header.tile_size > TILED_IMAGE_TILE_SIZE_MAX) {
+        printf("ERROR: File \"%s\" is not a valid tiled image!\n", input_filename);
+        fclose(ptr_input_file);
+        return 1;
+	}
+
+	// part of image that needs to be read
+	if (image_part_parameters.whole_part == WHOLE) {
+		row = 0;
+		col = 0;
+		input_image->width = header.width;
+		input_image->height = header.height;
+	} else {
+		if (image_part_parameters.row + image_part_parameters.height > header.height) {
+			printf("ERROR: Part of image rows exceed input image\n");
+			fclose(ptr_input_file);
+			return 1;
+		}
+		if (image_part_parameters.col + image_part_parameters.width > header.width) {
+			printf("ERROR: Part of image columns exceed input image\n");
+			fclose(ptr_input_file);
+			return 1;
+		}
+		row = image_part_parameters.row;
+		col = image_part_parameters.col;
+		input_image->width = image_part_parameters.width;
+		input_image->height = image_part_parameters.height;
+	}
+
+    // allocate buffer for input image
+	if (allocateImage(input_image, buffer)) {
+        printf("ERROR: Unable to allocate buffer for input image.\n");
+        fclose(ptr_input_file);
+        return 1;
+    }
+	if (input_image->width == 0 || input_image->height == 0) {
+        fclose(ptr_input_file);
+		return 0;
+	}
+
+	// tiles overlapping part of image
+	tiles_x = (header.width + header.tile_size - 1) / header.tile_size;
+	tx_first = col / header.tile_size;
+	tx_last = (col + input_image->width - 1) / header.tile_size;
+	ty_first = row / header.tile_size;
+	ty_last = (row + input_image->height - 1) / header.tile_size;
+
+	for (alt_u32 ty = ty_first; ty <= ty_last; ty++) {
+		alt_u32 y0 = ty * header.tile_size;
+		alt_u32 tile_height = (header.height - y0 < header.tile_size) ? header.height - y0 : header.tile_size;
+		// rows of this tile row that are inside part of image
+		alt_u32 y_start = (y0 > row) ? y0 : row;
+		alt_u32 y_end = (y0 + tile_height < row + input_image->height) ? y0 + tile_height : row + input_image->height;
+
+		for (alt_u32 tx_group = tx_first; tx_group <= tx_last; tx_group += TILED_IMAGE_READ_TILES) {
+			alt_u32 tiles_count = (tx_last - tx_group + 1 < TILED_IMAGE_READ_TILES) ? tx_last - tx_group + 1 : TILED_IMAGE_READ_TILES;
+			alt_u32 span;
+			alt_u8 *raw_tile;
+			alt_u8 *span_data;
+
+			// read index entries of this group
+			fseek(ptr_input_file, sizeof(header) + (ty * tiles_x + tx_group) * sizeof(TileIndexEntry_t), SEEK_SET);
+			if (fread(index, sizeof(TileIndexEntry_t), tiles_count, ptr_input_file) != tiles_count) {
+				printf("ERROR: Tiled image index is corrupted\n");
+				fclose(ptr_input_file);
+				return 1;
+			}
+			// tile is never bigger than raw tile, so span of group can not overflow
+			for (alt_u32 i = 0; i < tiles_count; i++) {
+				if (index[i].size > header.tile_size * header.tile_size ||
+					(i > 0 && index[i].offset != (alt_u64)index[i - 1].offset + index[i - 1].size)) {
+					printf("ERROR: Tiled image index is corrupted\n");
+					fclose(ptr_input_file);
+					return 1;
+				}
+			}
+			span = index[tiles_count - 1].offset + index[tiles_count - 1].size - index[0].offset;
+
+			// read all tiles of this group at once
+			if (reserveBuffer(tiles_buffer, header.tile_size * header.tile_size + span)) {
+				fclose(ptr_input_file);
+				return 1;
+			}
+			raw_tile = (alt_u8*)tiles_buffer->memory;
+			span_data = raw_tile + header.tile_size * header.tile_size;
+			fseek(ptr_input_file, index[0].offset, SEEK_SET);
+			if (readBlock(ptr_input_file, span_data, span)) {
+				printf("ERROR: Tiled image file is shorter than its index requires\n");
+				fclose(ptr_input_file);
+				return 1;
+			}
+
+			for (alt_u32 i = 0; i < tiles_count; i++) {
+				alt_u32 x0 = (tx_group + i) * header.tile_size;
+				alt_u32 tile_width = (header.width - x0 < header.tile_size) ? header.width - x0 : header.tile_size;
+				alt_u8 *tile_data = span_data + (index[i].offset - index[0].offset);
+				alt_u8 *tile;
+				// columns of this tile that are inside part of image
+				alt_u32 x_start = (x0 > col) ? x0 : col;
+				alt_u32 x_end = (x0 + tile_width < col + input_image->width) ? x0 + tile_width : col + input_image->width;
+
+				if (index[i].size == tile_width * tile_height) {
+					// raw tile is used in place
+					tile = tile_data;
+				} else if (rleDecode(tile_data, index[i].size, raw_tile, tile_width * tile_height) == 0) {
+					tile = raw_tile;
+				} else {
+					printf("ERROR: Tile [%u,%u] is corrupted\n", (unsigned int)ty, (unsigned int)(tx_group + i));
+					fclose(ptr_input_file);
+					return 1;
+				}
+
+				for (alt_u32 y = y_start; y < y_end; y++) {
+					memcpy(input_image->pixels + (y - row) * input_image->stride + (x_start - col),
+						   tile + (y - y0) * tile_width + (x_start - x0),
+						   x_end - x_start);
+				}
+			}
+		}
+	}
+
+    // close input file
+    fclose(ptr_input_file);
+
+#if VERBOSE_LEVEL>0
+	printf("loadTiledImage end.\n");
+#endif
+	return 0;
+}
+
+
+/*
+	------------------------------------------------------------------------------------------------
+	crc32 (IEEE 802.3, same as zlib crc32 and acc_scale) with slice-by-8 tables
+
+	crc32Update works on running crc register: start with 0xFFFFFFFF, invert at the end
+	------------------------------------------------------------------------------------------------
+*/
+static alt_u32 crc32_table[8][256];
+
+void crc32InitTables() {
+	for (alt_u32 i = 0; i < 256; i++) {
+		alt_u32 crc = i;
+		for (alt_u32 bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+		}
+		crc32_table[0][i] = crc;
+	}
+	for (alt_u32 i = 0; i < 256; i++) {
+		for (alt_u32 k = 1; k < 8; k++) {
+			crc32_table[k][i] = (crc32_table[k - 1][i] >> 8) ^ crc32_table[0][crc32_table[k - 1][i] & 0xFF];
+		}
+	}
+}
+
+alt_u32 crc32Update(alt_u32 crc, const alt_u8 *data, alt_u32 size) {
+	if (crc32_table[0][1] == 0) {
+		crc32InitTables();
+	}
+
+	// 8 bytes at a time
+	while (size >= 8) {
+		alt_u32 low = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((alt_u32)data[3] << 24));
+		alt_u32 high = data[4] | (data[5] << 8) | (data[6] << 16) | ((alt_u32)data[7] << 24);
+		crc = crc32_table[7][low & 0xFF] ^ crc32_table[6][(low >> 8) & 0xFF] ^
+			  crc32_table[5][(low >> 16) & 0xFF] ^ crc32_table[4][low >> 24] ^
+			  crc32_table[3][high & 0xFF] ^ crc32_table[2][(high >> 8) & 0xFF] ^
+			  crc32_table[1][(high >> 16) & 0xFF] ^ crc32_table[0][high >> 24];
+		data += 8;
+		size -= 8;
+	}
+	// remaining bytes
+	while (size > 0) {
+		crc = (crc >> 8) ^ crc32_table[0][(crc ^ *data) & 0xFF];
+		data++;
+		size--;
+	}
+	return crc;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	crc32 of image pixels, row by row
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 crc32Image(Image_t image) {
+	alt_u32 crc = 0xFFFFFFFF;
+
+	for (alt_u32 row = 0; row < image.height; row++) {
+		crc = crc32Update(crc, image.pixels + row * image.stride, image.width);
+	}
+	return ~crc;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	crc32 of output image that acc_scale makes from input image, computed from input image
+
+	output rows are formed in small chunk on stack and never written to memory, so only input image
+	is read (once for decrease, once per copy of row for increase). input pixels go through point
+	operation set in hw (see hwSetPointOperation).
+	------------------------------------------------------------------------------------------------
+*/
+#define CRC_CHUNK_SIZE 256
+
+alt_u32 crc32ScaledImage(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image) {
+
+	alt_u8 chunk[CRC_CHUNK_SIZE];
+	alt_u32 chunk_len = 0;
+	alt_u32 crc = 0xFFFFFFFF;
+
+	if (increase_decrease == INCREASE) {
+		for (alt_u32 in_row = 0; in_row < input_image.height; in_row++) {
+			alt_u8 *input_row = input_image.pixels + in_row * input_image.stride;
+			for (alt_u32 copy = 0; copy < scaling_factor; copy++) {
+				for (alt_u32 in_col = 0; in_col < input_image.width; in_col++) {
+					if (chunk_len + scaling_factor > CRC_CHUNK_SIZE) {
+						crc = crc32Update(crc, chunk, chunk_len);
+						chunk_len = 0;
+					}
+					for (alt_u32 k = 0; k < scaling_factor; k++) {
+						chunk[chunk_len++] = hw_point_table[input_row[in_col]];
+					}
+				}
+			}
+		}
+	} else {
+		for (alt_u32 in_row = 0; in_row < input_image.height; in_row += scaling_factor) {
+			alt_u8 *input_row = input_image.pixels + in_row * input_image.stride;
+			for (alt_u32 in_col = 0; in_col < input_image.width; in_col += scaling_factor) {
+				if (chunk_len == CRC_CHUNK_SIZE) {
+					crc = crc32Update(crc, chunk, chunk_len);
+					chunk_len = 0;
+				}
+				chunk[chunk_len++] = hw_point_table[input_row[in_col]];
+			}
+		}
+	}
+	crc = crc32Update(crc, chunk, chunk_len);
+	return ~crc;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	validate rows [first_row, last_row) of hw results that are in output image
+
+	increase: first of scaling_factor output rows made from one input row is compared with input
+	row pixel by pixel, its copies are compared with it using memcmp (word-wide). decrease: output
+	pixel [r,c] is compared with input pixel [r*scaling_factor,c*scaling_factor]. input pixels go
+	through point operation set in hw (see hwSetPointOperation). rows are read sequentially, so
+	any band of completed output rows can be validated on its own.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 validateRows(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image,
+        alt_u32 first_row,
+        alt_u32 last_row) {
+
+	for (alt_u32 out_row = first_row; out_row < last_row; out_row++) {
+		alt_u8 *output_row = output_image.pixels + out_row * output_image.stride;
+
+		if (increase_decrease == INCREASE && (out_row % scaling_factor) != 0) {
+			// copy of already validated row
+			alt_u8 *first_copy = output_row - (out_row % scaling_factor) * output_image.stride;
+			if (memcmp(output_row, first_copy, output_image.width) != 0) {
+				for (alt_u32 out_col = 0; out_col < output_image.width; out_col++) {
+					if (output_row[out_col] != first_copy[out_col]) {
+						printf("ValidateResultsHW: FAIL at pixel [%u,%u]\n", (unsigned int)out_row, (unsigned int)out_col);
+						return 1;
+					}
+				}
+			}
+		} else if (increase_decrease == INCREASE) {
+			alt_u8 *input_row = input_image.pixels + (out_row / scaling_factor) * input_image.stride;
+			alt_u32 out_col = 0;
+			for (alt_u32 in_col = 0; in_col < input_image.width; in_col++) {
+				for (alt_u32 k = 0; k < scaling_factor; k++, out_col++) {
+					if (output_row[out_col] != hw_point_table[input_row[in_col]]) {
+						printf("ValidateResultsHW: FAIL at pixel [%u,%u]\n", (unsigned int)out_row, (unsigned int)out_col);
+						return 1;
+					}
+				}
+			}
+		} else {
+			alt_u8 *input_row = input_image.pixels + out_row * scaling_factor * input_image.stride;
+			for (alt_u32 out_col = 0; out_col < output_image.width; out_col++) {
+				if (output_row[out_col] != hw_point_table[input_row[out_col * scaling_factor]]) {
+					printf("ValidateResultsHW: FAIL at pixel [%u,%u]\n", (unsigned int)out_row, (unsigned int)out_col);
+					return 1;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	validate hw results that are in output image
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 validateResultsHW(
+        ScalingFactor_t scaling_factor,
+        IncreaseDecreaseResolution_t increase_decrease,
+        Image_t input_image,
+        Image_t output_image) {
+
+	if (validateRows(scaling_factor, increase_decrease, input_image, output_image, 0, output_image.height) == 0) {
+		printf("ValidateResultsHW: SUCCESS!\n");
+	}
+    return 0;
+}
+
+#if HOST_BUILD==0
+/*
+	------------------------------------------------------------------------------------------------
+	reads crc32 of the last frame sent by acc_scale instance
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 readHwCrc(alt_u32 acc_scale_base) {
+	return (alt_u32)IORD_8DIRECT(acc_scale_base, ADDR_CRC_0) |
+		   ((alt_u32)IORD_8DIRECT(acc_scale_base, ADDR_CRC_1) << 8) |
+		   ((alt_u32)IORD_8DIRECT(acc_scale_base, ADDR_CRC_2) << 16) |
+		   ((alt_u32)IORD_8DIRECT(acc_scale_base, ADDR_CRC_3) << 24);
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	sets point operation that acc_scale input goes through
+
+	with FUSED_PIPELINE parameters are written to acc_linear_function chained in front of acc_scale
+	(no point operation is a=1, b=0, registers keep their values between transfers), without it
+	hw does no point operation and it is left to NIOS after scaling. expected hw results of
+	validation use the same point operation.
+	------------------------------------------------------------------------------------------------
+*/
+static PointOperation_t hw_point_operation;
+
+void hwSetPointOperation(const PointOperation_t *point_operation) {
+#if FUSED_PIPELINE>0
+	alt_8 a = 1;
+	alt_8 b = 0;
+	alt_u8 mode = LINEAR_MODE_LINEAR;
+
+	if (point_operation->type == POINT_LINEAR || point_operation->type == POINT_SATURATE) {
+		a = point_operation->a;
+		b = point_operation->b;
+		mode = (point_operation->type == POINT_SATURATE) ? LINEAR_MODE_SATURATE : LINEAR_MODE_LINEAR;
+	} else if (point_operation->type == POINT_LUT) {
+		mode = LINEAR_MODE_LUT;
+	}
+#if VERBOSE_LEVEL>0
+	printf("linear mode: %u, a: %d, b: %d\n", (unsigned int)mode, (int)a, (int)b);
+#endif
+	IOWR_8DIRECT(ACC_LINEAR_FUNCTION_BASE, ADDR_LINEAR_A, (alt_u8)a);
+	IOWR_8DIRECT(ACC_LINEAR_FUNCTION_BASE, ADDR_LINEAR_B, (alt_u8)b);
+	IOWR_8DIRECT(ACC_LINEAR_FUNCTION_BASE, ADDR_LINEAR_MODE, mode);
+	if (mode == LINEAR_MODE_LUT) {
+		for (alt_u32 x = 0; x < 256; x++) {
+			IOWR_8DIRECT(ACC_LINEAR_FUNCTION_BASE, ADDR_LINEAR_LUT, point_operation->lut[x]);
+		}
+	}
+	hw_point_operation = *point_operation;
+#else
+	(void)point_operation;
+	hw_point_operation.type = POINT_NONE;
+#endif
+	pointOperationTable(&hw_point_operation, hw_point_table);
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	data cache maintenance of image that DMA reads or writes
+
+	dcacheFlushImage writes back and invalidates cache lines of image. it is called before transfer
+	for input image (DMA reads what CPU wrote) and for output image (no dirty line can be written
+	back over DMA data later). dcacheInvalidateImage drops cache lines of output image after DMA
+	wrote it, so CPU can not read stale data. image buffers are aligned to cache lines (see
+	reserveBuffer), so lines at the ends of the range hold no other data.
+	------------------------------------------------------------------------------------------------
+*/
+void dcacheFlushImage(Image_t image) {
+	if (image.width > 0 && image.height > 0) {
+		alt_dcache_flush(image.pixels, (image.height - 1) * image.stride + image.width);
+	}
+}
+
+void dcacheInvalidateImage(Image_t image) {
+	if (image.width > 0 && image.height > 0) {
+		alt_dcache_flush_no_writeback(image.pixels, (image.height - 1) * image.stride + image.width);
+	}
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	Allocating descriptor table space from main memory.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 createDescriptors(
+		alt_sgdma_descriptor ** transmit_descriptors_p,
+        ReusableBuffer_t * transmit_descriptors_buffer,
+        alt_sgdma_descriptor ** receive_descriptors_p,
+        ReusableBuffer_t * receive_descriptors_buffer,
+		Image_t input_image,
+		Image_t output_image)
+{
+	/* Descriptor buffers are taken from job arena, which keeps them aligned to
+	 * DMA_BUFFER_ALIGNMENT (32 bytes, descriptor master is 256 bits wide) */
+	alt_u32 input_desctiptors_count;
+	alt_u32 output_desctiptors_count;
+	alt_u32 input_desctiptors_count_run;
+	alt_u32 output_desctiptors_count_run;
+	alt_u32 input_run_length, input_runs;
+	alt_u32 output_run_length, output_runs;
+	alt_sgdma_descriptor *transmit_descriptors, *receive_descriptors;
+	alt_u32 current_descriptor;
+
+	/*
+	   * Allocation of the transmit descriptors                   *
+	   * - First reserve a buffer in job arena                    *
+	   * - Second check for successful memory allocation          *
+	   * - Third use it directly, it is already 32 byte aligned   */
+
+	/* Images are transferred as runs of consecutive bytes. Rows of a packed image
+	 * (stride equal to width) follow each other in memory, so the whole image is one
+	 * long run. Part of image is a view into bigger image, so each of its rows is a
+	 * separate run read directly from the original buffer. */
+	if (input_image.stride == input_image.width) {
+		input_runs = 1;
+		input_run_length = input_image.width * input_image.height;
+	} else {
+		input_runs = input_image.height;
+		input_run_length = input_image.width;
+	}
+
+	if (output_image.stride == output_image.width) {
+		output_runs = 1;
+		output_run_length = output_image.width * output_image.height;
+	} else {
+		output_runs = output_image.height;
+		output_run_length = output_image.width;
+	}
+
+	// calculate number of descriptors for input image
+	// number of runs * number of descriptors per run
+	if (input_run_length % DESCRIPTOR_BUFFER_LEN_MAX) {
+		// checking potential overflow that may occur as a result of multiplication
+		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (input_run_length / DESCRIPTOR_BUFFER_LEN_MAX + 1)) < input_runs) {
+			printf("ERROR: While allocating descriptors. Input image is too big.\n");
+			return 1;
+		}
+		input_desctiptors_count_run = input_run_length / DESCRIPTOR_BUFFER_LEN_MAX + 1;
+		input_desctiptors_count = input_runs * input_desctiptors_count_run;
+	} else {
+		// checking potential overflow that may occur as a result of multiplication
+		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (input_run_length / DESCRIPTOR_BUFFER_LEN_MAX)) < input_runs) {
+			printf("ERROR: While allocating descriptors. Input image is too big.\n");
+			return 1;
+		}
+		input_desctiptors_count_run = input_run_length / DESCRIPTOR_BUFFER_LEN_MAX;
+		input_desctiptors_count = input_runs * input_desctiptors_count_run;
+	}
+
+#if VERBOSE_LEVEL>0
+    printf("Number of input descriptors: %u\n", (unsigned int)input_desctiptors_count);
+#endif
+
+	// checking potential overflow that may occur as a result of addition
+	if ((BIGGEST_32BIT_UNSIGNED_NUMBER - 1) < input_desctiptors_count) {
+		printf("ERROR: While allocating descriptors. Input image is too big.\n");
+		return 1;
+	}
+
+	// checking potential overflow that may occur as a result of multiplication
+	if ((BIGGEST_32BIT_UNSIGNED_NUMBER / ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE) < input_desctiptors_count + 1) {
+		printf("ERROR: While allocating descriptors. Input image is too big.\n");
+		return 1;
+	}
+
+	// descriptors and null descriptor that ends the chain
+	if(reserveBuffer(transmit_descriptors_buffer, (input_desctiptors_count + 1) * ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE))
+	{
+		printf("ERROR: Failed to allocate memory for the transmit descriptors\n");
+		return 1;
+	}
+	transmit_descriptors = (alt_sgdma_descriptor *)transmit_descriptors_buffer->memory;
+
+	*transmit_descriptors_p = transmit_descriptors;
+
+	/* Clear out the null descriptor owned by hardware bit.  These locations
+	 * came from job arena (used by previous jobs) so we don't know what state the bytes are in (owned bit could be high).*/
+	transmit_descriptors[input_desctiptors_count].control = 0;
+
+	/* Descriptors are filled by HAL with uncached writes, so cached copy of the table
+	 * (with the null descriptor written above) is written back and dropped now. */
+	alt_dcache_flush(transmit_descriptors, (input_desctiptors_count + 1) * ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE);
+
+	/*
+	   * Allocation of the receive descriptors                    *
+	   * - First reserve a buffer in job arena                    *
+	   * - Second check for successful memory allocation          *
+	   * - Third use it directly, it is already 32 byte aligned   */
+
+	// calculate number of descriptors for output image
+	// number of runs * number of descriptors per run
+	if (output_run_length % DESCRIPTOR_BUFFER_LEN_MAX) {
+		// checking potential overflow that may occur as a result of multiplication
+		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (output_run_length / DESCRIPTOR_BUFFER_LEN_MAX + 1)) < output_runs) {
+			printf("ERROR: While allocating descriptors. Input image is too big.\n");
+			return 1;
+		}
+		output_desctiptors_count_run = output_run_length / DESCRIPTOR_BUFFER_LEN_MAX + 1;
+		output_desctiptors_count = output_runs * output_desctiptors_count_run;
+	} else {
+		// checking potential overflow that may occur as a result of multiplication
+		if ((BIGGEST_32BIT_UNSIGNED_NUMBER / (output_run_length / DESCRIPTOR_BUFFER_LEN_MAX)) < output_runs) {
+			printf("ERROR: While allocating descriptors. Input image is too big.\n");
+			return 1;
+		}
+		output_desctiptors_count_run = output_run_length / DESCRIPTOR_BUFFER_LEN_MAX;
+		output_desctiptors_count = output_runs * output_desctiptors_count_run;
+	}
+
+#if VERBOSE_LEVEL>0
+    printf("Number of output descriptors: %u\n", (unsigned int)output_desctiptors_count);
+#endif
+
+	// checking potential overflow that may occur as a result of addition
+	if ((BIGGEST_32BIT_UNSIGNED_NUMBER - 1) < output_desctiptors_count) {
+		printf("ERROR: While allocating descriptors. Input image is too big.\n");
+		return 1;
+	}
+
+	// checking potential overflow that may occur as a result of multiplication
+	if ((BIGGEST_32BIT_UNSIGNED_NUMBER / ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE) < output_desctiptors_count + 1) {
+		printf("ERROR: While allocating descriptors. Input image is too big.\n");
+		return 1;
+	}
+
+	// descriptors and null descriptor that ends the chain
+	if(reserveBuffer(receive_descriptors_buffer, (output_desctiptors_count + 1) * ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE))
+	{
+		printf("ERROR: Failed to allocate memory for the receive descriptors\n");
+		return 1;
+	}
+	receive_descriptors = (alt_sgdma_descriptor *)receive_descriptors_buffer->memory;
+	*receive_descriptors_p = receive_descriptors;
+
+	/* Clear out the null descriptor owned by hardware bit.  These locations
+	 * came from job arena (used by previous jobs) so we don't know what state the bytes are in (owned bit could be high).*/
+	receive_descriptors[output_desctiptors_count].control = 0;
+
+	/* Descriptors are filled by HAL with uncached writes, so cached copy of the table
+	 * (with the null descriptor written above) is written back and dropped now. */
+	alt_dcache_flush(receive_descriptors, (output_desctiptors_count + 1) * ALTERA_AVALON_SGDMA_DESCRIPTOR_SIZE);
+
+	// fill allocated memory with transmit descriptor data
+	current_descriptor = 0;
+	for (alt_u32 i = 0; i < input_runs; i++) {
+		for (alt_u32 j = 0; j < input_desctiptors_count_run; j++) {
+			// current descriptor
+			// number of bytes to send
+			alt_u32 buffer_length;
+			if (j < input_desctiptors_count_run-1) {
+				// not last buffer in this run
+				buffer_length = DESCRIPTOR_BUFFER_LEN_MAX;
+			} else {
+				// last buffer in this run
+				buffer_length = input_run_length-j*DESCRIPTOR_BUFFER_LEN_MAX;
+			}
+
+			/* This will create a descriptor that is capable of transmitting data from an Avalon-MM buffer
+			 * to a packet enabled Avalon-ST FIFO component */
+			alt_avalon_sgdma_construct_mem_to_stream_desc(
+					&transmit_descriptors[current_descriptor],  							// current descriptor pointer
+					&transmit_descriptors[current_descriptor+1], 							// next descriptor pointer
+					(alt_u32*)&input_image.pixels[i * input_image.stride + j*DESCRIPTOR_BUFFER_LEN_MAX],	// read buffer location
+					(alt_u16)buffer_length,  								// length of the buffer
+					0, 		// reads are not from a fixed location
+					0,		// start of packet is disabled for the Avalon-ST interfaces
+					0, 		// end of packet is disabled for the Avalon-ST interfaces,
+					0);  	// there is only one channel
+			current_descriptor++;
+		}
+	}
+
+	// fill allocated memory with receive descriptor data
+	current_descriptor = 0;
+	for (alt_u32 i = 0; i < output_runs; i++) {
+		for (alt_u32 j = 0; j < output_desctiptors_count_run; j++) {
+			// number of bytes to send
+			alt_u32 buffer_length;
+			if (j < output_desctiptors_count_run-1) {
+				// not last buffer in this run
+				buffer_length = DESCRIPTOR_BUFFER_LEN_MAX;
+			} else {
+				// last buffer in this run
+				buffer_length = output_run_length-j*DESCRIPTOR_BUFFER_LEN_MAX;
+			}
+
+			/* This will create a descriptor that is capable of transmitting data from an Avalon-MM buffer
+			 * to a packet enabled Avalon-ST FIFO component */
+			alt_avalon_sgdma_construct_stream_to_mem_desc(
+					&receive_descriptors[current_descriptor],  							// current descriptor pointer
+					&receive_descriptors[current_descriptor+1], 							// next descriptor pointer
+					(alt_u32*)&output_image.pixels[i * output_image.stride + j*DESCRIPTOR_BUFFER_LEN_MAX],	// write buffer location
+					(alt_u16)buffer_length,  								// length of the buffer
+					0); // writes are not to a fixed location
+			current_descriptor++;
+		}
+	}
+
+#if VERBOSE_LEVEL>0
+    printf("createDescriptors end\n");
+#endif
+	return 0;  // no failures in allocation
+}
+
+
+/*
+	------------------------------------------------------------------------------------------------
+	configures acc_scale instance for input image and starts it, acc_scale then waits for input pixels
+	------------------------------------------------------------------------------------------------
+*/
+void hwStartScale(
+		alt_u32 acc_scale_base,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image) {
+
+#if VERBOSE_LEVEL>0
 	printf("width0: %u\n", (unsigned int)((input_image.width >> 0 ) & 0x000000FF));
 	printf("width1: %u\n", (unsigned int)((input_image.width >> 8 ) & 0x000000FF));
 	printf("width2: %u\n", (unsigned int)((input_image.width >> 16 ) & 0x000000FF));
 	printf("width3: %u\n", (unsigned int)((input_image.width >> 24 ) & 0x000000FF));
 
-	printf("height0: %u\n", (unsigned int)((input_image.height >> 0 ) & 0x000000FF));
-	printf("height1: %u\n", (unsigned int)((input_image.height >> 8 ) & 0x000000FF));
-	printf("height2: %u\n", (unsigned int)((input_image.height >> 16 ) & 0x000000FF));
-	printf("height3: %u\n", (unsigned int)((input_image.height >> 24 ) & 0x000000FF));
+	printf("height0: %u\n", (unsigned int)((input_image.height >> 0 ) & 0x000000FF));
+	printf("height1: %u\n", (unsigned int)((input_image.height >> 8 ) & 0x000000FF));
+	printf("height2: %u\n", (unsigned int)((input_image.height >> 16 ) & 0x000000FF));
+	printf("height3: %u\n", (unsigned int)((input_image.height >> 24 ) & 0x000000FF));
+#endif
+	// width
+	IOWR_8DIRECT(acc_scale_base, ADDR_WIDTH_0, (alt_8)((input_image.width >> 0 ) & 0x000000FF));
+	IOWR_8DIRECT(acc_scale_base, ADDR_WIDTH_1, (alt_8)((input_image.width >> 8 ) & 0x000000FF));
+	IOWR_8DIRECT(acc_scale_base, ADDR_WIDTH_2, (alt_8)((input_image.width >> 16) & 0x000000FF));
+	IOWR_8DIRECT(acc_scale_base, ADDR_WIDTH_3, (alt_8)((input_image.width >> 24) & 0x000000FF));
+
+	// height
+	IOWR_8DIRECT(acc_scale_base, ADDR_HEIGHT_0, (alt_8)((input_image.height >> 0 ) & 0x000000FF));
+	IOWR_8DIRECT(acc_scale_base, ADDR_HEIGHT_1, (alt_8)((input_image.height >> 8 ) & 0x000000FF));
+	IOWR_8DIRECT(acc_scale_base, ADDR_HEIGHT_2, (alt_8)((input_image.height >> 16) & 0x000000FF));
+	IOWR_8DIRECT(acc_scale_base, ADDR_HEIGHT_3, (alt_8)((input_image.height >> 24) & 0x000000FF));
+
+	// status is read only
+
+	// control
+	if (increase_decrease == INCREASE) {
+#if VERBOSE_LEVEL>0
+		printf("control: %02x\n", (unsigned int)(BIT_CONTROL_START + BIT_CONTROL_INCREASE + scaling_factor));
+#endif
+		IOWR_8DIRECT(acc_scale_base, ADDR_CONTROL, (unsigned char)(BIT_CONTROL_START + BIT_CONTROL_INCREASE + scaling_factor));
+	} else {
+#if VERBOSE_LEVEL>0
+		printf("control: %02x\n", (unsigned int)(BIT_CONTROL_START + scaling_factor));
+#endif
+		IOWR_8DIRECT(acc_scale_base, ADDR_CONTROL, (unsigned char)(BIT_CONTROL_START + scaling_factor));
+	}
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	number of output image rows that are in memory while transfer is running
+
+	receive descriptors (as laid out by createDescriptors) are parked, OWNED_BY_HW stays set, so
+	completed one is recognized by bytes transferred written back (HAL clears them when descriptor
+	is constructed). they are read past data cache. completed_descriptors is kept by caller between
+	calls, descriptors complete in order.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 completedRows(
+		alt_sgdma_descriptor *receive_descriptors,
+		Image_t output_image,
+		alt_u32 *completed_descriptors) {
+
+	alt_u32 receive_descriptors_count;
+	alt_u32 rows_completed;
+
+	if (output_image.stride == output_image.width) {
+		receive_descriptors_count = (output_image.width * output_image.height + DESCRIPTOR_BUFFER_LEN_MAX - 1) / DESCRIPTOR_BUFFER_LEN_MAX;
+	} else {
+		receive_descriptors_count = output_image.height * ((output_image.width + DESCRIPTOR_BUFFER_LEN_MAX - 1) / DESCRIPTOR_BUFFER_LEN_MAX);
+	}
+
+	while (*completed_descriptors < receive_descriptors_count &&
+		   IORD_16DIRECT(&(receive_descriptors[*completed_descriptors].actual_bytes_transferred), 0) != 0) {
+		(*completed_descriptors)++;
+	}
+
+	if (output_image.stride == output_image.width) {
+		rows_completed = (alt_u32)((alt_u64)*completed_descriptors * DESCRIPTOR_BUFFER_LEN_MAX / output_image.width);
+	} else {
+		rows_completed = *completed_descriptors / (receive_descriptors_count / output_image.height);
+	}
+	if (rows_completed > output_image.height) {
+		rows_completed = output_image.height;
+	}
+	return rows_completed;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	does acc_scale to image utilising hw accelerator
+
+	process: input image ---> output image
+
+	if validate_results is set, output rows are validated while the transfer is still running:
+	receive descriptors written back by s2m sgdma tell which rows are already in memory, those
+	rows are invalidated in data cache and validated (see validateRows). with VALIDATE_WITH_HW_CRC
+	expected crc32 is computed from input image in the transfer instead and rows are validated
+	only if crc32 read from acc_scale does not match, to find the failing pixel. mismatch that
+	validated rows do not explain fails too.
+
+	hwStartImage configures acc_scale and starts both transfers, hwFinishImage waits for them,
+	so processor is free for other work in between (see hybridProcessImage).
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 hwStartImage(
+		alt_u32 acc_scale_base,
+		alt_sgdma_dev * transmit_DMA,
+		alt_sgdma_descriptor * transmit_descriptors,
+		alt_sgdma_dev * receive_DMA,
+		alt_sgdma_descriptor * receive_descriptors,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image) {
+
+	// Configure acc_scale module.
+	hwStartScale(acc_scale_base, scaling_factor, increase_decrease, input_image);
+
+	// Starting both the transmit and receive transfers
+
+#if VERBOSE_LEVEL>0
+    printf("Starting up the SGDMA engines\n");
+#endif
+	// Start non blocking transfer with DMA modules.
+	if(alt_avalon_sgdma_do_async_transfer(transmit_DMA, &transmit_descriptors[0]) != 0) {
+		printf("Writing the head of the transmit descriptor list to the DMA failed\n");
+		return 1;
+	}
+	if(alt_avalon_sgdma_do_async_transfer(receive_DMA, &receive_descriptors[0]) != 0) {
+		printf("Writing the head of the receive descriptor list to the DMA failed\n");
+		return 1;
+	}
+	return 0;
+}
+
+alt_u32 hwFinishImage(
+		alt_u32 acc_scale_base,
+		alt_sgdma_dev * transmit_DMA,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * receive_DMA,
+		alt_sgdma_descriptor * receive_descriptors,
+		volatile alt_u16 * rx_done_p,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t output_image,
+		alt_u32 validate_results) {
+
+	alt_u32 completed_descriptors = 0;
+	alt_u32 rows_validated = 0;
+	alt_u32 rows_completed;
+	alt_u32 validation_failed = 0;
+#if VALIDATE_WITH_HW_CRC>0
+	alt_u32 expected_crc = 0;
+	alt_u32 hw_crc;
+#endif
+
+#if VALIDATE_WITH_HW_CRC>0
+	if (validate_results) {
+		expected_crc = crc32ScaledImage(scaling_factor, increase_decrease, input_image);
+	}
+#endif
+
+	// Blocking until the SGDMA interrupts fire, validating completed rows meanwhile
+	// (crc32 is checked when transfer is done, rows are not validated then)
+	while(*rx_done_p < 1) {
+		if (VALIDATE_WITH_HW_CRC>0 || !validate_results || validation_failed) {
+			continue;
+		}
+
+		rows_completed = completedRows(receive_descriptors, output_image, &completed_descriptors);
+		if (rows_completed > rows_validated) {
+			alt_dcache_flush_no_writeback(output_image.pixels + rows_validated * output_image.stride,
+										  (rows_completed - rows_validated - 1) * output_image.stride + output_image.width);
+			validation_failed = validateRows(scaling_factor, increase_decrease, input_image, output_image, rows_validated, rows_completed);
+			rows_validated = rows_completed;
+		}
+	}
+#if VERBOSE_LEVEL>0
+	printf("The receive SGDMA has completed\n");
+#endif
+	while(*tx_done_p < 1) {}
+#if VERBOSE_LEVEL>0
+	printf("The transmit SGDMA has completed\n");
+#endif
+
+	// output image is in memory now, cached copies of it are stale
+	dcacheInvalidateImage(output_image);
+
+	// rows completed after last check, with crc32 all rows if it does not match
+	if (validate_results) {
+#if VALIDATE_WITH_HW_CRC>0
+		hw_crc = readHwCrc(acc_scale_base);
+		if (hw_crc == expected_crc) {
+			rows_validated = output_image.height;
+		} else {
+			printf("ValidateResultsHW: CRC32 %08x does not match expected %08x\n", (unsigned int)hw_crc, (unsigned int)expected_crc);
+		}
+#endif
+		if (!validation_failed && rows_validated < output_image.height) {
+			validation_failed = validateRows(scaling_factor, increase_decrease, input_image, output_image, rows_validated, output_image.height);
+		}
+#if VALIDATE_WITH_HW_CRC>0
+		if (!validation_failed && hw_crc != expected_crc) {
+			printf("ValidateResultsHW: FAIL, all pixels are right but crc32 is not\n");
+			validation_failed = 1;
+		}
+#endif
+		if (!validation_failed) {
+			printf("ValidateResultsHW: SUCCESS!\n");
+		}
+	}
+
+	*tx_done_p = 0;
+	*rx_done_p = 0;
+
+	// Stop the SGDMAs
+	alt_avalon_sgdma_stop(transmit_DMA);
+	alt_avalon_sgdma_stop(receive_DMA);
+
+#if VERBOSE_LEVEL>0
+	printf("hwFinishImage end\n");
+#endif
+	return validation_failed;
+}
+
+alt_u32 hwProcessImage(
+		alt_sgdma_dev * transmit_DMA,
+		alt_sgdma_descriptor * transmit_descriptors,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * receive_DMA,
+		alt_sgdma_descriptor * receive_descriptors,
+		volatile alt_u16 * rx_done_p,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t output_image,
+		alt_u32 validate_results) {
+
+	if (hwStartImage(ACC_SCALE_BASE, transmit_DMA, transmit_descriptors, receive_DMA, receive_descriptors,
+					 scaling_factor, increase_decrease, input_image)) {
+		return 1;
+	}
+	return hwFinishImage(ACC_SCALE_BASE, transmit_DMA, tx_done_p, receive_DMA, receive_descriptors, rx_done_p,
+						 scaling_factor, increase_decrease, input_image, output_image, validate_results);
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	hybrid sw/hw processing
+
+	acc_scale gets top rows of input image through sgdma chains while NIOS scales the remaining
+	rows with sw row kernel. split is chosen so that both parts take the same time, from cycles
+	per output pixel of hw and sw measured by calibration for every scaling.
+	calibration is kept in HYBRID_CALIBRATION_FILENAME and reused by next runs.
+	------------------------------------------------------------------------------------------------
+*/
+typedef struct {
+	alt_u32 magic;
+	// cycles per 1024 output pixels, 0 means not calibrated
+	alt_u32 hw_cycles[INCREASE + 1][SCALING_FACTOR_MAX + 1];
+	alt_u32 sw_cycles[INCREASE + 1][SCALING_FACTOR_MAX + 1];
+} HybridCalibration_t;
+
+static HybridCalibration_t hybrid_calibration;
+
+void loadHybridCalibration() {
+	FILE *ptr_file = fopen(HYBRID_CALIBRATION_FILENAME, "rb");
+
+	memset(&hybrid_calibration, 0, sizeof(hybrid_calibration));
+	if (ptr_file == NULL) {
+		return;
+	}
+	if (readBlock(ptr_file, &hybrid_calibration, sizeof(hybrid_calibration)) ||
+		hybrid_calibration.magic != HYBRID_CALIBRATION_MAGIC) {
+		printf("WARNING: Hybrid calibration file is not valid, calibration is repeated\n");
+		memset(&hybrid_calibration, 0, sizeof(hybrid_calibration));
+	}
+	fclose(ptr_file);
+}
+
+alt_u32 storeHybridCalibration() {
+	FILE *ptr_file = fopen(HYBRID_CALIBRATION_FILENAME, "wb");
+	alt_u32 result;
+
+	if (ptr_file == NULL) {
+		printf("Unable to open file \"%s\"!\n", HYBRID_CALIBRATION_FILENAME);
+		return 1;
+	}
+	hybrid_calibration.magic = HYBRID_CALIBRATION_MAGIC;
+	result = writeBlock(ptr_file, &hybrid_calibration, sizeof(hybrid_calibration));
+	if (result) {
+		printf("ERROR: Unable to write file \"%s\"!\n", HYBRID_CALIBRATION_FILENAME);
+	}
+	fclose(ptr_file);
+	return result;
+}
+
+// records hw and sw cycles measured on output image of output_pixels pixels
+alt_u32 recordHybridCalibration(
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		alt_u64 output_pixels,
+		alt_u64 hw_cycles,
+		alt_u64 sw_cycles) {
+
+	if (output_pixels == 0 || hw_cycles == 0 || sw_cycles == 0) {
+		return 0;
+	}
+	hybrid_calibration.hw_cycles[increase_decrease][scaling_factor] = (alt_u32)((hw_cycles * 1024 + output_pixels - 1) / output_pixels);
+	hybrid_calibration.sw_cycles[increase_decrease][scaling_factor] = (alt_u32)((sw_cycles * 1024 + output_pixels - 1) / output_pixels);
+#if VERBOSE_LEVEL>0
+	printf("Hybrid calibration %s%u: hw %u, sw %u cycles per 1024 pixels\n", (increase_decrease == INCREASE) ? "x" : "/",
+			(unsigned int)scaling_factor,
+			(unsigned int)hybrid_calibration.hw_cycles[increase_decrease][scaling_factor],
+			(unsigned int)hybrid_calibration.sw_cycles[increase_decrease][scaling_factor]);
+#endif
+	return storeHybridCalibration();
+}
+
+/*
+	runs calibration image through hw and sw if scaling is not calibrated yet. job buffers are
+	used for calibration images, so it has to run before job images are placed in them.
+	performance counter sections 3 and 4 are used, global counter has to be running.
+*/
+alt_u32 calibrateHybrid(
+		alt_sgdma_dev * transmit_DMA,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * receive_DMA,
+		volatile alt_u16 * rx_done_p,
+		JobBuffers_t *job_buffers,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease) {
+
+	alt_sgdma_descriptor *m2s_desc;
+	alt_sgdma_descriptor *s2m_desc;
+	Image_t input_image;
+	Image_t output_image;
+	alt_u64 hw_cycles;
+	alt_u64 sw_cycles;
+
+	if (HYBRID_PROCESSING == 0 ||
+		(hybrid_calibration.hw_cycles[increase_decrease][scaling_factor] != 0 &&
+		 hybrid_calibration.sw_cycles[increase_decrease][scaling_factor] != 0)) {
+		return 0;
+	}
+
+	resetJobBuffers(job_buffers);
+	input_image.width = HYBRID_CALIBRATION_SIZE;
+	input_image.height = HYBRID_CALIBRATION_SIZE;
+	if (allocateImage(&input_image, &(job_buffers->input_image))) {
+		return 1;
+	}
+	for (alt_u32 i = 0; i < input_image.width * input_image.height; i++) {
+		input_image.pixels[i] = (alt_u8)i;
+	}
+	if (formOutputImage(scaling_factor, increase_decrease, input_image, &output_image, &(job_buffers->output_image)) ||
+		createDescriptors(&m2s_desc, &(job_buffers->m2s_descriptors), &s2m_desc, &(job_buffers->s2m_descriptors), input_image, output_image)) {
+		resetJobBuffers(job_buffers);
+		return 1;
+	}
+
+	dcacheFlushImage(input_image);
+	dcacheFlushImage(output_image);
+
+	hw_cycles = perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 3);
+	PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 3);
+	if (hwProcessImage(transmit_DMA, m2s_desc, tx_done_p, receive_DMA, s2m_desc, rx_done_p,
+					   scaling_factor, increase_decrease, input_image, output_image, 0)) {
+		PERF_END(PERFORMANCE_COUNTER_BASE, 3);
+		resetJobBuffers(job_buffers);
+		return 1;
+	}
+	PERF_END(PERFORMANCE_COUNTER_BASE, 3);
+	hw_cycles = perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 3) - hw_cycles;
+
+	sw_cycles = perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 4);
+	PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 4);
+	swProcessImage(scaling_factor, increase_decrease, input_image, output_image);
+	PERF_END(PERFORMANCE_COUNTER_BASE, 4);
+	sw_cycles = perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 4) - sw_cycles;
+
+	resetJobBuffers(job_buffers);
+	return recordHybridCalibration(scaling_factor, increase_decrease,
+								   (alt_u64)output_image.width * output_image.height, hw_cycles, sw_cycles);
+}
+
+/*
+	number of top input rows given to acc_scale, rest is scaled by NIOS. all rows go to hw when
+	hybrid processing is off, scaling is not calibrated or sw part would be too small. for
+	decrease hw rows are multiple of scaling_factor. output of hw part ends on data cache line
+	boundary, so NIOS never writes back a cache line that sgdma is writing. if there is no such
+	boundary above balanced split, all rows go to hw too.
+*/
+alt_u32 hybridHwRows(
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t output_image) {
+
+	alt_u64 hw_cycles = hybrid_calibration.hw_cycles[increase_decrease][scaling_factor];
+	alt_u64 sw_cycles = hybrid_calibration.sw_cycles[increase_decrease][scaling_factor];
+	alt_u32 hw_output_rows;
+	alt_u32 hw_rows;
+	alt_u32 rows_step = (increase_decrease == INCREASE) ? 1 : scaling_factor;
+
+	if (HYBRID_PROCESSING == 0 || hw_cycles == 0 || sw_cycles == 0) {
+		return input_image.height;
+	}
+
+	// both parts take the same time: hw_rows * hw_cycles == sw_rows * sw_cycles
+	hw_output_rows = (alt_u32)(output_image.height * sw_cycles / (hw_cycles + sw_cycles));
+	if ((output_image.height - hw_output_rows) * HYBRID_MIN_SW_SHARE < output_image.height) {
+		return input_image.height;
+	}
+
+	hw_rows = (increase_decrease == INCREASE) ? hw_output_rows / scaling_factor : hw_output_rows * scaling_factor;
+	while (hw_rows > 0) {
+		hw_output_rows = (increase_decrease == INCREASE) ? hw_rows * scaling_factor : hw_rows / scaling_factor;
+		if (((uintptr_t)(output_image.pixels + hw_output_rows * output_image.stride) % DMA_BUFFER_ALIGNMENT) == 0) {
+			break;
+		}
+		hw_rows = (hw_rows > rows_step) ? hw_rows - rows_step : 0;
+	}
+	return (hw_rows > 0) ? hw_rows : input_image.height;
+}
+
+/*
+	does acc_scale to image utilising hw accelerator and NIOS at the same time
+
+	top hybridHwRows rows go to acc_scale, NIOS scales the rest of the rows while the transfer is
+	running and does point operation set in hw on them. only hw part is validated (if
+	validate_results is set).
+*/
+alt_u32 hybridProcessImage(
+		alt_sgdma_dev * transmit_DMA,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * receive_DMA,
+		volatile alt_u16 * rx_done_p,
+		JobBuffers_t *job_buffers,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t output_image,
+		alt_u32 validate_results) {
+
+	alt_sgdma_descriptor *m2s_desc;
+	alt_sgdma_descriptor *s2m_desc;
+	Image_t hw_input_image = input_image;
+	Image_t hw_output_image = output_image;
+
+	hw_input_image.height = hybridHwRows(scaling_factor, increase_decrease, input_image, output_image);
+	if (hw_input_image.height == 0) {
+		return swPointProcessImage(&hw_point_operation, scaling_factor, increase_decrease, input_image, output_image);
+	}
+	if (hw_input_image.height < input_image.height) {
+		hw_output_image.height = (increase_decrease == INCREASE) ?
+				hw_input_image.height * scaling_factor : hw_input_image.height / scaling_factor;
+	}
+#if VERBOSE_LEVEL>0
+	printf("hybridProcessImage: %u of %u output rows on hw\n", (unsigned int)hw_output_image.height, (unsigned int)output_image.height);
+#endif
+
+	if (createDescriptors(&m2s_desc, &(job_buffers->m2s_descriptors), &s2m_desc, &(job_buffers->s2m_descriptors), hw_input_image, hw_output_image)) {
+		return 1;
+	}
+
+	dcacheFlushImage(hw_input_image);
+	dcacheFlushImage(hw_output_image);
+
+	if (hwStartImage(ACC_SCALE_BASE, transmit_DMA, m2s_desc, receive_DMA, s2m_desc, scaling_factor, increase_decrease, hw_input_image)) {
+		return 1;
+	}
+	if (hw_output_image.height < output_image.height) {
+		swProcessRows(scaling_factor, increase_decrease, input_image, output_image, hw_output_image.height, output_image.height,
+					  swSelectRowKernel(scaling_factor, increase_decrease));
+		if (hw_point_operation.type != POINT_NONE) {
+			swPointOperationRows(hw_point_table, output_image, hw_output_image.height, output_image.height);
+		}
+	}
+	return hwFinishImage(ACC_SCALE_BASE, transmit_DMA, tx_done_p, receive_DMA, s2m_desc, rx_done_p,
+						 scaling_factor, increase_decrease, hw_input_image, hw_output_image, validate_results);
+}
+
+#if TRAFFIC_TEST>0
+/*
+	------------------------------------------------------------------------------------------------
+	traffic test: stream_generator --> acc_scale --> stream_checker
+
+	generator sends pattern frame, checker receives scaled frame. CRC32 computed by checker is
+	compared with CRC32 of scaling of the same pattern done in software, with scaling factor 1
+	(acc_scale passes pixels unchanged) checker also compares every pixel with pattern. throughput
+	is output pixels per clock counted by checker from the first to the last received pixel, Mpix/s
+	assumes stream components are clocked with CPU clock. stalls (generator waits for acc_scale)
+	and idle clocks (checker waits for acc_scale) show which side limits the accelerator.
+	------------------------------------------------------------------------------------------------
+*/
+void streamWrite32(alt_u32 base, alt_u32 address, alt_u32 value) {
+	IOWR_8DIRECT(base, address + 0, (alt_u8)((value >> 0 ) & 0x000000FF));
+	IOWR_8DIRECT(base, address + 1, (alt_u8)((value >> 8 ) & 0x000000FF));
+	IOWR_8DIRECT(base, address + 2, (alt_u8)((value >> 16) & 0x000000FF));
+	IOWR_8DIRECT(base, address + 3, (alt_u8)((value >> 24) & 0x000000FF));
+}
+
+alt_u32 streamRead32(alt_u32 base, alt_u32 address) {
+	return (alt_u32)IORD_8DIRECT(base, address + 0) |
+		   ((alt_u32)IORD_8DIRECT(base, address + 1) << 8) |
+		   ((alt_u32)IORD_8DIRECT(base, address + 2) << 16) |
+		   ((alt_u32)IORD_8DIRECT(base, address + 3) << 24);
+}
+
+// configures generator or checker for one frame, frame is started by streamStart
+void streamConfigure(alt_u32 base, alt_u32 width, alt_u32 height, alt_u8 value, alt_u8 gap_period, alt_u8 gap_length) {
+	IOWR_8DIRECT(base, ADDR_STREAM_CONTROL, BIT_CONTROL_RESET);
+	streamWrite32(base, ADDR_STREAM_WIDTH, width);
+	streamWrite32(base, ADDR_STREAM_HEIGHT, height);
+	IOWR_8DIRECT(base, ADDR_STREAM_VALUE, value);
+	IOWR_8DIRECT(base, ADDR_STREAM_GAP_PERIOD, gap_period);
+	IOWR_8DIRECT(base, ADDR_STREAM_GAP_LENGTH, gap_length);
+}
+
+// image with pixels stream_generator sends, row by row
+void streamPatternImage(StreamPattern_t pattern, alt_u8 value, Image_t image) {
+	alt_u8 pixel = (pattern == PATTERN_PRBS && value == 0) ? 1 : value;
+
+	for (alt_u32 row = 0; row < image.height; row++) {
+		alt_u8 *pixels = image.pixels + row * image.stride;
+		for (alt_u32 col = 0; col < image.width; col++) {
+			pixels[col] = pixel;
+			if (pattern == PATTERN_RAMP) {
+				pixel++;
+			} else if (pattern == PATTERN_PRBS) {
+				// LFSR x^8 + x^6 + x^5 + x^4 + 1
+				pixel = (alt_u8)((pixel << 1) | (((pixel >> 7) ^ (pixel >> 5) ^ (pixel >> 4) ^ (pixel >> 3)) & 1));
+			}
+		}
+	}
+}
+
+alt_u32 runTrafficCase(const TrafficCase_t *traffic_case, JobBuffers_t *job_buffers) {
+	const char *pattern_names[] = { "ramp", "prbs", "const" };
+	Image_t input_image;
+	Image_t output_image;
+	alt_u32 expected_crc;
+	alt_u32 compare;
+	alt_u32 start;
+	alt_u32 cycles, stalls, idle, errors, crc;
+	alt_u32 output_pixels;
+	alt_u32 failed;
+
+	resetJobBuffers(job_buffers);
+	input_image.width = traffic_case->width;
+	input_image.height = traffic_case->height;
+	if (allocateImage(&input_image, &(job_buffers->input_image))) {
+		printf("ERROR: Unable to allocate buffer for traffic test image.\n");
+		return 1;
+	}
+	if (outputImageSize(traffic_case->scaling_factor, traffic_case->increase_decrease, input_image, &output_image)) {
+		return 1;
+	}
+	streamPatternImage(traffic_case->pattern, traffic_case->value, input_image);
+	expected_crc = crc32ScaledImage(traffic_case->scaling_factor, traffic_case->increase_decrease, input_image);
+	compare = (traffic_case->scaling_factor == SF1);
+
+	// sink first, then accelerator and source at last
+	streamConfigure(STREAM_CHECKER_BASE, output_image.width, output_image.height, traffic_case->value,
+					traffic_case->ready_period, traffic_case->ready_length);
+	IOWR_8DIRECT(STREAM_CHECKER_BASE, ADDR_STREAM_CONTROL,
+				 (alt_u8)(BIT_CONTROL_START | (compare ? BIT_STREAM_CONTROL_COMPARE : 0) | traffic_case->pattern));
+	hwStartScale(ACC_SCALE_BASE, traffic_case->scaling_factor, traffic_case->increase_decrease, input_image);
+	streamConfigure(STREAM_GENERATOR_BASE, input_image.width, input_image.height, traffic_case->value,
+					traffic_case->gap_period, traffic_case->gap_length);
+	IOWR_8DIRECT(STREAM_GENERATOR_BASE, ADDR_STREAM_CONTROL, (alt_u8)(BIT_CONTROL_START | traffic_case->pattern));
+
+	start = alt_nticks();
+	while ((IORD_8DIRECT(STREAM_GENERATOR_BASE, ADDR_STREAM_STATUS) & BIT_STREAM_STATUS_BUSY) ||
+		   (IORD_8DIRECT(STREAM_CHECKER_BASE, ADDR_STREAM_STATUS) & BIT_STREAM_STATUS_BUSY)) {
+		if (alt_nticks() - start > TRAFFIC_TIMEOUT_SECONDS * alt_ticks_per_second()) {
+			printf("ERROR: Traffic test %ux%u timed out, generator sent %u clocks, checker received %u clocks.\n",
+				   (unsigned int)input_image.width, (unsigned int)input_image.height,
+				   (unsigned int)streamRead32(STREAM_GENERATOR_BASE, ADDR_STREAM_CYCLES),
+				   (unsigned int)streamRead32(STREAM_CHECKER_BASE, ADDR_STREAM_CYCLES));
+			IOWR_8DIRECT(STREAM_GENERATOR_BASE, ADDR_STREAM_CONTROL, BIT_CONTROL_RESET);
+			IOWR_8DIRECT(STREAM_CHECKER_BASE, ADDR_STREAM_CONTROL, BIT_CONTROL_RESET);
+			IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_CONTROL, BIT_CONTROL_RESET);
+			return 1;
+		}
+	}
+
+	cycles = streamRead32(STREAM_CHECKER_BASE, ADDR_STREAM_CYCLES);
+	stalls = streamRead32(STREAM_GENERATOR_BASE, ADDR_STREAM_STALLS);
+	idle = streamRead32(STREAM_CHECKER_BASE, ADDR_STREAM_IDLE);
+	errors = streamRead32(STREAM_CHECKER_BASE, ADDR_STREAM_ERRORS);
+	crc = streamRead32(STREAM_CHECKER_BASE, ADDR_STREAM_CRC);
+	output_pixels = output_image.width * output_image.height;
+	failed = (crc != expected_crc) || (errors != 0);
+
+	printf("%5ux%-5u %s x%u %-7s %3u/%-3u %3u/%-3u %10u %8.3f %8.2f %10u %10u %8u %s\n",
+		   (unsigned int)input_image.width, (unsigned int)input_image.height,
+		   (traffic_case->increase_decrease == INCREASE) ? "inc" : "dec", (unsigned int)traffic_case->scaling_factor,
+		   pattern_names[traffic_case->pattern],
+		   (unsigned int)traffic_case->gap_period, (unsigned int)traffic_case->gap_length,
+		   (unsigned int)traffic_case->ready_period, (unsigned int)traffic_case->ready_length,
+		   (unsigned int)cycles, (double)output_pixels / cycles, (double)output_pixels * alt_get_cpu_freq() / cycles / 1000000,
+		   (unsigned int)stalls, (unsigned int)idle, (unsigned int)errors, failed ? "FAIL" : "OK");
+	if (crc != expected_crc) {
+		printf("ERROR: Traffic test CRC32 %08x does not match expected %08x\n", (unsigned int)crc, (unsigned int)expected_crc);
+	}
+	return failed;
+}
+
+alt_u32 runTrafficTest(JobBuffers_t *job_buffers) {
+	// width, height, scaling, increase/decrease, pattern, value, valid gaps, ready drops
+	const TrafficCase_t traffic_cases[] = {
+		{  640,  480, SF1, DECREASE, PATTERN_RAMP,     0,  0, 0,  0, 0 },
+		{  640,  480, SF1, DECREASE, PATTERN_PRBS,     1,  0, 0,  0, 0 },
+		{  640,  480, SF1, DECREASE, PATTERN_PRBS,     1,  7, 3, 11, 5 },
+		{ 1024,  768, SF2, DECREASE, PATTERN_PRBS,    17,  0, 0,  0, 0 },
+		{ 1024,  768, SF4, DECREASE, PATTERN_RAMP,     0,  0, 0,  0, 0 },
+		{  640,  480, SF2, INCREASE, PATTERN_PRBS,    17,  0, 0,  0, 0 },
+		{  640,  480, SF2, INCREASE, PATTERN_PRBS,    17,  0, 0,  3, 1 },
+		{  320,  240, SF4, INCREASE, PATTERN_CONSTANT, 85, 16, 4, 64, 2 },
+	};
+	alt_u32 cases_failed = 0;
+	PointOperation_t point_operation;
+
+	// generator feeds acc_scale directly, expected results have no point operation
+	point_operation.type = POINT_NONE;
+	hwSetPointOperation(&point_operation);
+
+	printf("Traffic test, stream_generator --> acc_scale --> stream_checker\n");
+	printf("%-11s %-6s %-7s %-7s %-7s %10s %8s %8s %10s %10s %8s\n",
+		   "Frame", "Scale", "Pattern", "Gaps", "Ready", "Cycles", "Pix/clk", "Mpix/s", "Stalls", "Idle", "Errors");
+	for (alt_u32 i = 0; i < sizeof(traffic_cases) / sizeof(traffic_cases[0]); i++) {
+		cases_failed += runTrafficCase(&traffic_cases[i], job_buffers);
+	}
+	resetJobBuffers(job_buffers);
+	return (cases_failed > 0);
+}
+#endif
+#endif
+
+/*
+	------------------------------------------------------------------------------------------------
+	main
+	------------------------------------------------------------------------------------------------
+*/
+
+#if HOST_BUILD==0
+// s2m sgdma interrupt
+void transmit_callback_function(void * context)
+{
+	alt_u16 *tx_done = (alt_u16*) context;
+	(*tx_done)++;  /* main will be polling for this value being 1 */
+}
+
+void receive_callback_function(void * context)
+{
+	alt_u16 *rx_done = (alt_u16*) context;
+	(*rx_done)++;  /* main will be polling for this value being 1 */
+}
+#endif
+
+/*
+	------------------------------------------------------------------------------------------------
+	splits job into at most bands independent horizontal bands, returns number of bands (0 on error)
+
+	for decrease every band starts on input row that is multiple of scaling factor, so band keeps
+	decimation phase of the whole image and bands scaled one by one give the same output as the
+	whole image. output of every band starts on DMA_BUFFER_ALIGNMENT boundary, so band scaled by
+	NIOS never shares data cache line with band written by sgdma. boundary is moved up until its
+	output row is aligned, bands around boundary that can not be aligned are merged.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 partitionImage(
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t output_image,
+		alt_u32 bands,
+		ScaleWork_t *work) {
+
+	alt_u32 rows_step = (increase_decrease == INCREASE) ? 1 : scaling_factor;
+	alt_u32 count = 0;
+	alt_u32 first_row = 0;
+
+	for (alt_u32 band = 1; band <= bands && first_row < input_image.height; band++) {
+		alt_u32 last_row = input_image.height;
+		alt_u32 first_output_row = (increase_decrease == INCREASE) ? first_row * scaling_factor : first_row / scaling_factor;
+		ScaleWork_t *band_work;
+
+		if (band < bands) {
+			last_row = (alt_u32)((alt_u64)band * input_image.height / bands) / rows_step * rows_step;
+			while (last_row > first_row) {
+				alt_u32 last_output_row = (increase_decrease == INCREASE) ? last_row * scaling_factor : last_row / scaling_factor;
+				if (((uintptr_t)(output_image.pixels + last_output_row * output_image.stride) % DMA_BUFFER_ALIGNMENT) == 0) {
+					break;
+				}
+				last_row -= rows_step;
+			}
+			if (last_row <= first_row) {
+				continue;
+			}
+		}
+
+		band_work = &work[count++];
+		band_work->input_image = input_image;
+		band_work->input_image.height = last_row - first_row;
+		band_work->input_image.pixels = input_image.pixels + first_row * input_image.stride;
+		if (outputImageSize(scaling_factor, increase_decrease, band_work->input_image, &(band_work->output_image))) {
+			return 0;
+		}
+		band_work->output_image.stride = output_image.stride;
+		band_work->output_image.pixels = output_image.pixels + first_output_row * output_image.stride;
+		first_row = last_row;
+	}
+	return count;
+}
+
+// scales band by NIOS, with point operation that hw would do
+alt_u32 swProcessBand(
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		const ScaleWork_t *work) {
+
+#if HOST_BUILD>0
+	return swProcessImageParallel(scaling_factor, increase_decrease, work->input_image, work->output_image, 0);
+#else
+	swProcessRows(scaling_factor, increase_decrease, work->input_image, work->output_image, 0, work->output_image.height,
+				  swSelectRowKernel(scaling_factor, increase_decrease));
+	if (hw_point_operation.type != POINT_NONE) {
+		swPointOperationRows(hw_point_table, work->output_image, 0, work->output_image.height);
+	}
+	return 0;
+#endif
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	acc_scale instances and dispatcher of bands
+
+	job is split into horizontal bands (every band starts on input row that is multiple of scaling
+	factor), bands are given to idle instances until all of them are done. every instance has its
+	own pair of sgdmas, its own descriptors and its own done flags, so they work at the same time
+	and throughput grows with number of instances until sdram bandwidth is used up. NIOS scales
+	band itself when it would otherwise only wait for instances (see BAND_SW_WORKER).
+
+	on host the same dispatcher drives software model of instances: instance needs one clock per
+	input or output pixel (whichever is more) and all the busy instances share
+	ACC_SCALE_MODEL_SDRAM_BYTES per clock. band is scaled in software when modeled instance is done,
+	so results are the same as with hw and modeled clocks show how throughput scales.
+	------------------------------------------------------------------------------------------------
+*/
+static AccScaleInstance_t acc_scale_instances[ACC_SCALE_INSTANCES];
+static alt_u32 acc_scale_instances_count;
+static volatile alt_u16 acc_scale_tx_done[ACC_SCALE_INSTANCES];
+static volatile alt_u16 acc_scale_rx_done[ACC_SCALE_INSTANCES];
+static alt_u64 acc_scale_model_clocks;
+static alt_u32 band_sw_bands;
+static alt_u64 band_sw_output_pixels;
+
+// instance 0 uses sgdmas and done flags of main, instances that can not be opened are left out
+alt_u32 openAccScaleInstances(
+		alt_sgdma_dev * sgdma_m2s,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * sgdma_s2m,
+		volatile alt_u16 * rx_done_p) {
+
+	memset(acc_scale_instances, 0, sizeof(acc_scale_instances));
+	acc_scale_instances_count = 0;
+	acc_scale_model_clocks = 0;
+	band_sw_bands = 0;
+	band_sw_output_pixels = 0;
+
+#if HOST_BUILD>0
+	(void)sgdma_m2s;
+	(void)tx_done_p;
+	(void)sgdma_s2m;
+	(void)rx_done_p;
+	acc_scale_instances_count = ACC_SCALE_INSTANCES;
+#else
+	const alt_u32 bases[] = {
+		ACC_SCALE_BASE,
+#if ACC_SCALE_INSTANCES>1
+		ACC_SCALE_1_BASE,
+#endif
+#if ACC_SCALE_INSTANCES>2
+		ACC_SCALE_2_BASE,
+#endif
+#if ACC_SCALE_INSTANCES>3
+		ACC_SCALE_3_BASE,
+#endif
+	};
+	const char *m2s_names[] = { "/dev/sgdma_m2s", "/dev/sgdma_m2s_1", "/dev/sgdma_m2s_2", "/dev/sgdma_m2s_3" };
+	const char *s2m_names[] = { "/dev/sgdma_s2m", "/dev/sgdma_s2m_1", "/dev/sgdma_s2m_2", "/dev/sgdma_s2m_3" };
+
+	for (alt_u32 i = 0; i < ACC_SCALE_INSTANCES; i++) {
+		AccScaleInstance_t *instance = &acc_scale_instances[i];
+
+		instance->base = bases[i];
+		if (i == 0) {
+			instance->m2s = sgdma_m2s;
+			instance->s2m = sgdma_s2m;
+			instance->tx_done_p = tx_done_p;
+			instance->rx_done_p = rx_done_p;
+		} else {
+			instance->m2s = alt_avalon_sgdma_open(m2s_names[i]);
+			instance->s2m = alt_avalon_sgdma_open(s2m_names[i]);
+			instance->tx_done_p = &acc_scale_tx_done[i];
+			instance->rx_done_p = &acc_scale_rx_done[i];
+		}
+		if (instance->m2s == NULL || instance->s2m == NULL) {
+			printf("ERROR: Could not open %s and %s, %u acc_scale instances are used\n", m2s_names[i], s2m_names[i], (unsigned int)i);
+			break;
+		}
+		alt_avalon_sgdma_register_callback(
+				instance->m2s,
+				&transmit_callback_function,
+				(ALTERA_AVALON_SGDMA_CONTROL_IE_GLOBAL_MSK |
+				 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
+				 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
+				(void*)instance->tx_done_p);
+		alt_avalon_sgdma_register_callback(
+				instance->s2m,
+				&receive_callback_function,
+				(ALTERA_AVALON_SGDMA_CONTROL_IE_GLOBAL_MSK |
+				 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
+				 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
+				(void*)instance->rx_done_p);
+		acc_scale_instances_count++;
+	}
+#endif
+	return (acc_scale_instances_count == 0);
+}
+
+// starts work on idle instance
+static alt_u32 accScaleStart(
+		alt_u32 index,
+		JobBuffers_t *job_buffers,
+		const ScaleWork_t *work,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease) {
+
+	AccScaleInstance_t *instance = &acc_scale_instances[index];
+
+#if HOST_BUILD>0
+	double input_pixels = (double)work->input_image.width * work->input_image.height;
+	double output_pixels = (double)work->output_image.width * work->output_image.height;
+
+	(void)job_buffers;
+	(void)scaling_factor;
+	(void)increase_decrease;
+	instance->model_clocks_left = (input_pixels > output_pixels) ? input_pixels : output_pixels;
+	instance->model_bytes_per_clock = (input_pixels + output_pixels) / instance->model_clocks_left;
+#else
+	alt_sgdma_descriptor *m2s_desc;
+
+	if (createDescriptors(&m2s_desc, &(job_buffers->band_m2s_descriptors[index]), &(instance->s2m_desc),
+						  &(job_buffers->band_s2m_descriptors[index]), work->input_image, work->output_image)) {
+		return 1;
+	}
+	dcacheFlushImage(work->input_image);
+	dcacheFlushImage(work->output_image);
+	if (hwStartImage(instance->base, instance->m2s, m2s_desc, instance->s2m, instance->s2m_desc,
+					 scaling_factor, increase_decrease, work->input_image)) {
+		return 1;
+	}
+#endif
+	instance->work = work;
+	return 0;
+}
+
+// 1 when work of busy instance is done
+static alt_u32 accScaleDone(const AccScaleInstance_t *instance) {
+#if HOST_BUILD>0
+	return (instance->model_clocks_left <= 0);
+#else
+	return (*(instance->rx_done_p) > 0);
+#endif
+}
+
+// collects results of done work, instance is idle after it
+static alt_u32 accScaleFinish(
+		AccScaleInstance_t *instance,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		alt_u32 validate_results) {
+
+	const ScaleWork_t *work = instance->work;
+	alt_u32 result;
+
+#if HOST_BUILD>0
+	(void)validate_results;
+	swProcessRows(scaling_factor, increase_decrease, work->input_image, work->output_image, 0, work->output_image.height,
+				  swSelectRowKernel(scaling_factor, increase_decrease));
+	result = 0;
+#else
+	result = hwFinishImage(instance->base, instance->m2s, instance->tx_done_p, instance->s2m, instance->s2m_desc, instance->rx_done_p,
+						   scaling_factor, increase_decrease, work->input_image, work->output_image, validate_results);
+#endif
+	instance->bands++;
+	instance->output_pixels += (alt_u64)work->output_image.width * work->output_image.height;
+	instance->work = NULL;
+	return result;
+}
+
+#if HOST_BUILD>0
+// host model: ACC_SCALE_MODEL_STEP clocks of all the busy instances
+static void accScaleModelStep() {
+	double demand = 0;
+	double speed = 1;
+
+	for (alt_u32 i = 0; i < acc_scale_instances_count; i++) {
+		if (acc_scale_instances[i].work != NULL) {
+			demand += acc_scale_instances[i].model_bytes_per_clock;
+		}
+	}
+	if (demand > ACC_SCALE_MODEL_SDRAM_BYTES) {
+		speed = ACC_SCALE_MODEL_SDRAM_BYTES / demand;
+	}
+	for (alt_u32 i = 0; i < acc_scale_instances_count; i++) {
+		if (acc_scale_instances[i].work != NULL) {
+			acc_scale_instances[i].model_clocks_left -= ACC_SCALE_MODEL_STEP * speed;
+		}
+	}
+	acc_scale_model_clocks += ACC_SCALE_MODEL_STEP;
+}
+#endif
+
+// with FUSED_PIPELINE point operation is set only in acc_linear_function in front of instance 0
+static alt_u32 accScaleUsable(alt_u32 index) {
+#if FUSED_PIPELINE>0
+	return (index == 0 || hw_point_operation.type == POINT_NONE);
+#else
+	(void)index;
+	return 1;
+#endif
+}
+
+static alt_u32 accScaleUsableCount() {
+	alt_u32 count = 0;
+
+	for (alt_u32 i = 0; i < acc_scale_instances_count; i++) {
+		count += accScaleUsable(i);
+	}
+	return count;
+}
+
+// 1 when NIOS scales work[next_work] before instances are done with the rest of work
+static alt_u32 swTakesBand(
+		const ScaleWork_t *work,
+		alt_u32 next_work,
+		alt_u32 work_count,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease) {
+
+	alt_u64 band_pixels = (alt_u64)work[next_work].output_image.width * work[next_work].output_image.height;
+	alt_u64 rest_pixels = 0;
+#if HOST_BUILD>0
+	alt_u64 hw_cycles = 1024;
+	alt_u64 sw_cycles = 1024 * ACC_SCALE_MODEL_SW_CLOCKS;
+
+	(void)scaling_factor;
+	(void)increase_decrease;
+#else
+	alt_u64 hw_cycles = hybrid_calibration.hw_cycles[increase_decrease][scaling_factor];
+	alt_u64 sw_cycles = hybrid_calibration.sw_cycles[increase_decrease][scaling_factor];
+#endif
+
+	if (BAND_SW_WORKER == 0 || hw_cycles == 0 || sw_cycles == 0) {
+		return 0;
+	}
+	for (alt_u32 i = next_work + 1; i < work_count; i++) {
+		rest_pixels += (alt_u64)work[i].output_image.width * work[i].output_image.height;
+	}
+	return (band_pixels * sw_cycles <= rest_pixels * hw_cycles / accScaleUsableCount());
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	gives work items to idle instances until all of them are done
+
+	when every instance is busy NIOS may scale the next work item itself (see swTakesBand), done
+	instances wait meanwhile. work is not started any more after the first error, work already
+	started is waited for.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 dispatchScaleWork(
+		const ScaleWork_t *work,
+		alt_u32 work_count,
+		JobBuffers_t *job_buffers,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		alt_u32 validate_results) {
+
+	alt_u32 next_work = 0;
+	alt_u32 busy = 0;
+	alt_u32 failed = 0;
+
+	while (busy > 0 || (!failed && next_work < work_count)) {
+#if HOST_BUILD>0
+		if (busy > 0) {
+			accScaleModelStep();
+		}
+#endif
+		for (alt_u32 i = 0; i < acc_scale_instances_count; i++) {
+			AccScaleInstance_t *instance = &acc_scale_instances[i];
+
+			if (instance->work != NULL && accScaleDone(instance)) {
+				failed |= accScaleFinish(instance, scaling_factor, increase_decrease, validate_results);
+				busy--;
+			}
+			if (instance->work == NULL && accScaleUsable(i) && !failed && next_work < work_count) {
+#if VERBOSE_LEVEL>0
+				printf("dispatchScaleWork: work %u to instance %u\n", (unsigned int)next_work, (unsigned int)i);
+#endif
+				if (accScaleStart(i, job_buffers, &work[next_work], scaling_factor, increase_decrease)) {
+					failed = 1;
+				} else {
+					busy++;
+				}
+				next_work++;
+			}
+		}
+		if (busy > 0 && !failed && next_work < work_count &&
+			swTakesBand(work, next_work, work_count, scaling_factor, increase_decrease)) {
+			const ScaleWork_t *band = &work[next_work++];
+#if VERBOSE_LEVEL>0
+			printf("dispatchScaleWork: work %u to NIOS\n", (unsigned int)(next_work - 1));
+#endif
+#if HOST_BUILD>0
+			// instances go on while modeled NIOS scales band
+			for (double clocks = (double)band->output_image.width * band->output_image.height * ACC_SCALE_MODEL_SW_CLOCKS;
+				 clocks > 0; clocks -= ACC_SCALE_MODEL_STEP) {
+				accScaleModelStep();
+			}
+#endif
+			failed |= swProcessBand(scaling_factor, increase_decrease, band);
+			band_sw_bands++;
+			band_sw_output_pixels += (alt_u64)band->output_image.width * band->output_image.height;
+		}
+	}
+	return failed;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	scales image on all acc_scale instances and NIOS, image is split into bands of rows
+
+	small images are not split (see ACC_SCALE_BAND_MIN_PIXELS). with FUSED_PIPELINE image with
+	point operation goes to instance 0 and NIOS only.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 multiProcessImage(
+		JobBuffers_t *job_buffers,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t output_image,
+		alt_u32 validate_results) {
+
+	ScaleWork_t work[BANDS_MAX];
+	alt_u32 work_count;
+	alt_u32 bands = accScaleUsableCount() * ACC_SCALE_BANDS_PER_INSTANCE;
+	alt_u32 max_bands = (alt_u32)((alt_u64)input_image.width * input_image.height / ACC_SCALE_BAND_MIN_PIXELS);
+
+	if (bands > BANDS_MAX) {
+		bands = BANDS_MAX;
+	}
+	if (bands > max_bands) {
+		bands = (max_bands > 0) ? max_bands : 1;
+	}
+
+	work_count = partitionImage(scaling_factor, increase_decrease, input_image, output_image, bands, work);
+	if (work_count == 0) {
+		return 1;
+	}
+#if VERBOSE_LEVEL>0
+	printf("multiProcessImage: %u bands\n", (unsigned int)work_count);
+#endif
+	return dispatchScaleWork(work, work_count, job_buffers, scaling_factor, increase_decrease, validate_results);
+}
+
+void printAccScaleReport() {
+	alt_u64 output_pixels = band_sw_output_pixels;
+
+	for (alt_u32 i = 0; i < acc_scale_instances_count; i++) {
+		printf("acc_scale %u:        %u bands, %llu output pixels\n", (unsigned int)i,
+			   (unsigned int)acc_scale_instances[i].bands, (unsigned long long)acc_scale_instances[i].output_pixels);
+		output_pixels += acc_scale_instances[i].output_pixels;
+	}
+	printf("NIOS bands:         %u bands, %llu output pixels\n", (unsigned int)band_sw_bands, (unsigned long long)band_sw_output_pixels);
+#if HOST_BUILD>0
+	if (acc_scale_model_clocks > 0) {
+		printf("acc_scale model:    %llu clocks, %.3f output pixels/clock\n",
+			   (unsigned long long)acc_scale_model_clocks, (double)output_pixels / acc_scale_model_clocks);
+	}
+#else
+	(void)output_pixels;
+#endif
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	image pyramid: all levels from one read of input
+
+	with acc_pyramid s2m sgdma of every level is started first, then m2s sgdma sends input once.
+	levels are validated against input after transfer (if validate_results is set). without
+	acc_pyramid (and on host) levels are made by NIOS (see swPyramidImage).
+	------------------------------------------------------------------------------------------------
+*/
+#if HW_PYRAMID>0
+static alt_sgdma_dev *pyramid_m2s;
+static alt_sgdma_dev *pyramid_s2m[PYRAMID_LEVELS_MAX];
+static volatile alt_u16 pyramid_tx_done;
+static volatile alt_u16 pyramid_rx_done[PYRAMID_LEVELS_MAX];
+
+// sgdmas of acc_pyramid, pyramid is made by NIOS if they can not be opened
+void openPyramid() {
+	const char *s2m_names[] = { "/dev/sgdma_s2m_pyramid_1", "/dev/sgdma_s2m_pyramid_2", "/dev/sgdma_s2m_pyramid_3" };
+
+	pyramid_m2s = alt_avalon_sgdma_open("/dev/sgdma_m2s_pyramid");
+	for (alt_u32 i = 0; i < PYRAMID_LEVELS_MAX; i++) {
+		pyramid_s2m[i] = alt_avalon_sgdma_open(s2m_names[i]);
+		if (pyramid_s2m[i] == NULL) {
+			pyramid_m2s = NULL;
+		}
+	}
+	if (pyramid_m2s == NULL) {
+		printf("ERROR: Could not open sgdmas of acc_pyramid, pyramid is made by NIOS\n");
+		return;
+	}
+	alt_avalon_sgdma_register_callback(
+			pyramid_m2s,
+			&transmit_callback_function,
+			(ALTERA_AVALON_SGDMA_CONTROL_IE_GLOBAL_MSK |
+			 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
+			 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
+			(void*)&pyramid_tx_done);
+	for (alt_u32 i = 0; i < PYRAMID_LEVELS_MAX; i++) {
+		alt_avalon_sgdma_register_callback(
+				pyramid_s2m[i],
+				&receive_callback_function,
+				(ALTERA_AVALON_SGDMA_CONTROL_IE_GLOBAL_MSK |
+				 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
+				 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
+				(void*)&pyramid_rx_done[i]);
+	}
+}
+
+// pixel [row,col] of level k is input pixel [row*2^k,col*2^k], as decrease by 2^k in acc_scale
+alt_u32 validatePyramidRows(Image_t input_image, Image_t *levels, alt_u32 level_index, alt_u32 first_row, alt_u32 last_row) {
+	if (validateRows((ScalingFactor_t)(2u << level_index), DECREASE, input_image, levels[level_index], first_row, last_row)) {
+		printf("ValidateResultsHW: FAIL in pyramid level %u\n", (unsigned int)(level_index + 1));
+		return 1;
+	}
+	return 0;
+}
+
+alt_u32 hwPyramidImage(
+		JobBuffers_t *job_buffers,
+		Image_t input_image,
+		Image_t *levels,
+		alt_u32 levels_count,
+		alt_u32 validate_results) {
+
+	alt_sgdma_descriptor *m2s_desc;
+	alt_sgdma_descriptor *s2m_desc[PYRAMID_LEVELS_MAX];
+	alt_u32 completed_descriptors[PYRAMID_LEVELS_MAX];
+	alt_u32 rows_validated[PYRAMID_LEVELS_MAX];
+	alt_u32 rows_completed;
+	alt_u32 levels_done;
+	alt_u32 validation_failed = 0;
+	PointOperation_t point_operation;
+
+	// acc_pyramid has no point operation in front, levels are validated against raw input pixels
+	// (batch sets point operation of every job again)
+	point_operation.type = POINT_NONE;
+	hwSetPointOperation(&point_operation);
+
+	// input chain is the same for every level, it is built again with receive chain of level
+	for (alt_u32 i = 0; i < levels_count; i++) {
+		if (createDescriptors(&m2s_desc, &(job_buffers->m2s_descriptors), &s2m_desc[i], &(job_buffers->pyramid_s2m_descriptors[i]),
+							  input_image, levels[i])) {
+			return 1;
+		}
+		dcacheFlushImage(levels[i]);
+		pyramid_rx_done[i] = 0;
+		completed_descriptors[i] = 0;
+		rows_validated[i] = 0;
+	}
+	dcacheFlushImage(input_image);
+	pyramid_tx_done = 0;
+
+	// width and height, then start with number of levels
+	IOWR_8DIRECT(ACC_PYRAMID_BASE, ADDR_CONTROL, BIT_CONTROL_RESET);
+	for (alt_u32 i = 0; i < 4; i++) {
+		IOWR_8DIRECT(ACC_PYRAMID_BASE, ADDR_WIDTH_0 + i, (alt_u8)((input_image.width >> (8 * i)) & 0x000000FF));
+		IOWR_8DIRECT(ACC_PYRAMID_BASE, ADDR_HEIGHT_0 + i, (alt_u8)((input_image.height >> (8 * i)) & 0x000000FF));
+	}
+	IOWR_8DIRECT(ACC_PYRAMID_BASE, ADDR_CONTROL, (alt_u8)(BIT_CONTROL_START + levels_count));
+
+	for (alt_u32 i = 0; i < levels_count; i++) {
+		if (alt_avalon_sgdma_do_async_transfer(pyramid_s2m[i], &s2m_desc[i][0]) != 0) {
+			printf("Writing the head of the receive descriptor list to the DMA failed\n");
+			return 1;
+		}
+	}
+	if (alt_avalon_sgdma_do_async_transfer(pyramid_m2s, &m2s_desc[0]) != 0) {
+		printf("Writing the head of the transmit descriptor list to the DMA failed\n");
+		return 1;
+	}
+
+	// Blocking until every level is received, validating completed rows of levels meanwhile
+	// (the same way as hwFinishImage)
+	do {
+		levels_done = 0;
+		for (alt_u32 i = 0; i < levels_count; i++) {
+			if (pyramid_rx_done[i] > 0) {
+				levels_done++;
+			}
+			if (!validate_results || validation_failed) {
+				continue;
+			}
+			rows_completed = completedRows(s2m_desc[i], levels[i], &completed_descriptors[i]);
+			if (rows_completed > rows_validated[i]) {
+				alt_dcache_flush_no_writeback(levels[i].pixels + rows_validated[i] * levels[i].stride,
+											  (rows_completed - rows_validated[i] - 1) * levels[i].stride + levels[i].width);
+				validation_failed = validatePyramidRows(input_image, levels, i, rows_validated[i], rows_completed);
+				rows_validated[i] = rows_completed;
+			}
+		}
+	} while (levels_done < levels_count);
+	while (pyramid_tx_done < 1) {}
+	alt_avalon_sgdma_stop(pyramid_m2s);
+	for (alt_u32 i = 0; i < levels_count; i++) {
+		alt_avalon_sgdma_stop(pyramid_s2m[i]);
+		dcacheInvalidateImage(levels[i]);
+	}
+
+	// rows completed after last check
+	for (alt_u32 i = 0; validate_results && !validation_failed && i < levels_count; i++) {
+		if (rows_validated[i] < levels[i].height) {
+			validation_failed = validatePyramidRows(input_image, levels, i, rows_validated[i], levels[i].height);
+		}
+	}
+	if (validate_results && !validation_failed) {
+		printf("ValidateResultsHW: SUCCESS!\n");
+	}
+	return validation_failed;
+}
+#endif
+
+alt_u32 pyramidProcessImage(
+		JobBuffers_t *job_buffers,
+		Image_t input_image,
+		Image_t *levels,
+		alt_u32 levels_count,
+		alt_u32 validate_results) {
+
+#if HW_PYRAMID>0
+	if (pyramid_m2s != NULL) {
+		return hwPyramidImage(job_buffers, input_image, levels, levels_count, validate_results);
+	}
+#endif
+	(void)job_buffers;
+	(void)validate_results;
+	swPyramidImage(input_image, levels, levels_count);
+	return 0;
+}
+
+// output filename of pyramid level: divisor of level is added before extension ("a.bin" -> "a_4.bin")
+alt_u32 pyramidLevelFilename(alt_8 *output_filename, alt_u32 level, alt_8 *level_filename) {
+	char *extension = strrchr((char*)output_filename, '.');
+	char *directory = strrchr((char*)output_filename, '/');
+	alt_u32 base_len;
+
+	if (extension == NULL || (directory != NULL && extension < directory)) {
+		extension = (char*)output_filename + strlen((char*)output_filename);
+	}
+	base_len = extension - (char*)output_filename;
+	if (strlen((char*)output_filename) + 4 >= PATH_MAX_LEN) {
+		printf("ERROR: Output filename \"%s\" is too long\n", output_filename);
+		return 1;
+	}
+	memcpy(level_filename, output_filename, base_len);
+	sprintf((char*)level_filename + base_len, "_%u%s", (unsigned int)(1u << level), extension);
+	return 0;
+}
+
+// levels of pyramid job, point operation is done on levels, every level is stored in its own file
+alt_u32 pyramidJob(
+		BatchJob_t *job,
+		alt_8 *output_filename,
+		JobBuffers_t *job_buffers,
+		Image_t input_image,
+		alt_u64 *output_pixels) {
+
+	Image_t levels[PYRAMID_LEVELS_MAX];
+	alt_8 level_filename[PATH_MAX_LEN];
+
+	for (alt_u32 i = 0; i < job->pyramid_levels; i++) {
+		alt_u32 step = 2u << i;
+
+		levels[i].width = (input_image.width + step - 1) / step;
+		levels[i].height = (input_image.height + step - 1) / step;
+		if (allocateImage(&levels[i], &(job_buffers->pyramid_images[i]))) {
+			printf("ERROR: Unable to allocate buffer for pyramid level.\n");
+			return 1;
+		}
+	}
+
+	PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+	if (pyramidProcessImage(job_buffers, input_image, levels, job->pyramid_levels, (BATCH_VALIDATE_RESULTS > 0))) {
+		PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+		return 1;
+	}
+	for (alt_u32 i = 0; i < job->pyramid_levels; i++) {
+		swPointOperationImage(&(job->point_operation), levels[i]);
+	}
+	PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+
+	for (alt_u32 i = 0; i < job->pyramid_levels; i++) {
+		if (pyramidLevelFilename(output_filename, i + 1, level_filename) ||
+			(isTiledImage(level_filename) ?
+				storeTiledImage(level_filename, levels[i], &(job_buffers->tiles)) :
+				storeImage(level_filename, levels[i]))) {
+			return 1;
+		}
+		*output_pixels += (alt_u64)levels[i].width * levels[i].height;
+	}
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	fit to box: plans scaling of image into box
+
+	output keeps aspect ratio of input and is as big as fits into the box. candidates are every
+	integer acc_scale scaling whose output is at least output size (then residual resize only
+	takes pixels away, or is not needed at all) and resize of input by NIOS alone. candidate with
+	the lowest estimated cycles wins, with equal cycles the smaller acc_scale output. acc_scale
+	cycles come from hybrid calibration, FIT_HW_CYCLES_PER_PIXEL is used for scaling that is not
+	calibrated (and on host). resize by NIOS mostly waits for cache lines of input rows, so
+	smaller acc_scale output makes it cheaper.
+	------------------------------------------------------------------------------------------------
+*/
+static alt_u64 fitHwCycles(
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t input_image,
+		Image_t stage_image) {
+
+	alt_u64 input_pixels = (alt_u64)input_image.width * input_image.height;
+	alt_u64 stage_pixels = (alt_u64)stage_image.width * stage_image.height;
+#if HOST_BUILD==0
+	alt_u64 hw_cycles = hybrid_calibration.hw_cycles[increase_decrease][scaling_factor];
+
+	if (hw_cycles != 0) {
+		return stage_pixels * hw_cycles / 1024;
+	}
+#else
+	(void)scaling_factor;
+	(void)increase_decrease;
+#endif
+	return ((input_pixels > stage_pixels) ? input_pixels : stage_pixels) * FIT_HW_CYCLES_PER_PIXEL;
+}
+
+// every output row of resize reads cache lines of one input row, at most one line per output pixel
+static alt_u64 fitSwCycles(Image_t stage_image, alt_u32 width, alt_u32 height) {
+	alt_u64 lines = (stage_image.width + DMA_BUFFER_ALIGNMENT - 1) / DMA_BUFFER_ALIGNMENT;
+
+	if (lines > width) {
+		lines = width;
+	}
+	return (alt_u64)width * height * FIT_SW_RESIZE_CYCLES + lines * height * FIT_SW_LINE_CYCLES;
+}
+
+alt_u32 planFitToBox(Image_t input_image, alt_u32 box_width, alt_u32 box_height, FitPlan_t *plan) {
+	FitPlan_t candidate;
+	alt_u64 best_stage_pixels;
+
+	if (input_image.width == 0 || input_image.height == 0 || box_width == 0 || box_height == 0) {
+		printf("ERROR: Fit to box needs non empty image and box\n");
+		return 1;
+	}
+
+	// output size, the other side is rounded down (at least one pixel)
+	memset(&candidate, 0, sizeof(candidate));
+	if ((alt_u64)box_width * input_image.height <= (alt_u64)box_height * input_image.width) {
+		candidate.width = box_width;
+		candidate.height = (alt_u32)((alt_u64)input_image.height * box_width / input_image.width);
+	} else {
+		candidate.width = (alt_u32)((alt_u64)input_image.width * box_height / input_image.height);
+		candidate.height = box_height;
+	}
+	candidate.width = (candidate.width > 0) ? candidate.width : 1;
+	candidate.height = (candidate.height > 0) ? candidate.height : 1;
+
+	// NIOS alone
+	candidate.residual = 1;
+	candidate.cycles = fitSwCycles(input_image, candidate.width, candidate.height);
+	*plan = candidate;
+	best_stage_pixels = (alt_u64)input_image.width * input_image.height;
+
+	// acc_scale stage, then residual resize if needed
+	for (alt_u32 increase_decrease = DECREASE; increase_decrease <= INCREASE; increase_decrease++) {
+		for (alt_u32 scaling_factor = SCALING_FACTOR_MIN; scaling_factor <= SCALING_FACTOR_MAX; scaling_factor++) {
+			Image_t stage_image;
+			alt_u64 stage_pixels;
+
+			if ((increase_decrease == INCREASE && scaling_factor == SCALING_FACTOR_MIN) ||
+				outputImageSize(scaling_factor, increase_decrease, input_image, &stage_image) ||
+				stage_image.width < candidate.width || stage_image.height < candidate.height) {
+				continue;
+			}
+			stage_pixels = (alt_u64)stage_image.width * stage_image.height;
+			candidate.hw_stage = 1;
+			candidate.scaling_factor = scaling_factor;
+			candidate.increase_decrease = increase_decrease;
+			candidate.residual = (stage_image.width != candidate.width || stage_image.height != candidate.height);
+			candidate.cycles = fitHwCycles(scaling_factor, increase_decrease, input_image, stage_image);
+			if (candidate.residual) {
+				candidate.cycles += fitSwCycles(stage_image, candidate.width, candidate.height);
+			}
+			if (candidate.cycles < plan->cycles || (candidate.cycles == plan->cycles && stage_pixels < best_stage_pixels)) {
+				*plan = candidate;
+				best_stage_pixels = stage_pixels;
+			}
+		}
+	}
+#if VERBOSE_LEVEL>0
+	printf("planFitToBox: %ux%u into %ux%u -> %ux%u, acc_scale %s%u, residual %u, %llu cycles\n",
+		   (unsigned int)input_image.width, (unsigned int)input_image.height, (unsigned int)box_width, (unsigned int)box_height,
+		   (unsigned int)plan->width, (unsigned int)plan->height, plan->hw_stage ? ((plan->increase_decrease == INCREASE) ? "x" : "/") : "-",
+		   (unsigned int)plan->scaling_factor, (unsigned int)plan->residual, (unsigned long long)plan->cycles);
+#endif
+	return 0;
+}
+
+// size of image (or of its part) that batch job scales, without loading it
+alt_u32 batchJobInputSize(BatchJob_t *job, Image_t *input_image) {
+	if (job->image_part_parameters.whole_part == PART) {
+		input_image->width = job->image_part_parameters.width;
+		input_image->height = job->image_part_parameters.height;
+		return 0;
+	}
+	if (isTiledImage(job->input_filename)) {
+		FILE *ptr_input_file;
+		TiledImageHeader_t header;
+		alt_8 input_filename_nios[PATH_MAX_LEN];
+
+		if (strlen((char*)job->input_filename) + sizeof(INPUT_DIRECTORY) > PATH_MAX_LEN) {
+			printf("ERROR: Input filename \"%s\" is too long\n", job->input_filename);
+			return 1;
+		}
+		strcpy((char*)input_filename_nios, INPUT_DIRECTORY);
+		strcat((char*)input_filename_nios, (char*)job->input_filename);
+		ptr_input_file = fopen((char*)input_filename_nios, "rb");
+		if (ptr_input_file == NULL) {
+			printf("ERROR: Unable to open file \"%s\"!\n", job->input_filename);
+			return 1;
+		}
+		if (fread(&header, sizeof(header), 1, ptr_input_file) != 1 || header.magic != TILED_IMAGE_MAGIC) {
+			printf("ERROR: File \"%s\" is not a valid tiled image!\n", job->input_filename);
+			fclose(ptr_input_file);
+			return 1;
+		}
+		fclose(ptr_input_file);
+		input_image->width = header.width;
+		input_image->height = header.height;
+	} else {
+		FILE *ptr_input_file = openImage(job->input_filename, input_image);
+		if (ptr_input_file == NULL) {
+			return 1;
+		}
+		fclose(ptr_input_file);
+	}
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	frame sequence: scaling of frames that change only in small regions
+
+	frame job keeps its input and output at start of job arena. next frame job with the same
+	input size, scaling and point operation is compared with kept input in tiles of
+	FRAME_TILE_SIZE x FRAME_TILE_SIZE pixels and only changed tiles are scaled into kept output.
+	changed tiles next to each other in tile row are part of image (see formInputImage) and tile
+	rows with the same changed tiles are scaled together, so changed rectangle is one transfer.
+	any other job ends the sequence.
+	------------------------------------------------------------------------------------------------
+*/
+static FrameSequence_t frame_sequence;
+static alt_u64 frame_tiles;
+static alt_u64 frame_tiles_changed;
+
+alt_u32 samePointOperation(const PointOperation_t *a, const PointOperation_t *b) {
+	if (a->type != b->type) {
+		return 0;
+	}
+	switch (a->type) {
+	case POINT_LINEAR:
+	case POINT_SATURATE:
+		return a->a == b->a && a->b == b->b;
+	case POINT_LUT:
+		return memcmp(a->lut, b->lut, sizeof(a->lut)) == 0;
+	default:
+		return 1;
+	}
+}
+
+// job is the next frame of current sequence
+alt_u32 frameSequenceContinues(BatchJob_t *job) {
+	Image_t input_image;
+
+	return job->frame && frame_sequence.frames > 0 &&
+		   job->scaling_factor == frame_sequence.scaling_factor &&
+		   job->increase_decrease == frame_sequence.increase_decrease &&
+		   samePointOperation(&(job->point_operation), &(frame_sequence.point_operation)) &&
+		   batchJobInputSize(job, &input_image) == 0 &&
+		   input_image.width == frame_sequence.input_image.width &&
+		   input_image.height == frame_sequence.input_image.height;
+}
+
+// ends frame sequence, memory kept by it is given back by next resetJobBuffers
+void frameSequenceEnd() {
+	releaseBuffer(&(frame_sequence.input_buffer));
+	releaseBuffer(&(frame_sequence.output_buffer));
+	frame_sequence.frames = 0;
+	job_arena.kept = 0;
+}
+
+// first frame job of sequence takes kept images from empty job arena (called right after resetJobBuffers)
+alt_u32 frameSequenceStart(BatchJob_t *job) {
+	if (frame_sequence.frames > 0) {
+		return 0;
+	}
+	if (batchJobInputSize(job, &(frame_sequence.input_image)) ||
+		allocateImage(&(frame_sequence.input_image), &(frame_sequence.input_buffer)) ||
+		formOutputImage(job->scaling_factor, job->increase_decrease, frame_sequence.input_image,
+						&(frame_sequence.output_image), &(frame_sequence.output_buffer))) {
+		frameSequenceEnd();
+		return 1;
+	}
+	frame_sequence.scaling_factor = job->scaling_factor;
+	frame_sequence.increase_decrease = job->increase_decrease;
+	frame_sequence.point_operation = job->point_operation;
+	job_arena.kept = job_arena.used;
+	return 0;
+}
+
+// changed[i] is set if tile i of tile row differs from kept input (every tile of first frame)
+void frameChangedTiles(Image_t input_image, alt_u32 tile_row, alt_u8 *changed, alt_u32 tile_cols) {
+	Image_t previous_image = frame_sequence.input_image;
+	alt_u32 first_row = tile_row * FRAME_TILE_SIZE;
+	alt_u32 last_row = (first_row + FRAME_TILE_SIZE < input_image.height) ? first_row + FRAME_TILE_SIZE : input_image.height;
+	alt_u32 unchanged = tile_cols;
+
+	memset(changed, (frame_sequence.frames == 0), tile_cols);
+	for (alt_u32 row = first_row; row < last_row && unchanged > 0 && frame_sequence.frames > 0; row++) {
+		alt_u8 *input_pixels = input_image.pixels + row * input_image.stride;
+		alt_u8 *previous_pixels = previous_image.pixels + row * previous_image.stride;
+
+		for (alt_u32 i = 0; i < tile_cols; i++) {
+			alt_u32 col = i * FRAME_TILE_SIZE;
+			alt_u32 width = (col + FRAME_TILE_SIZE < input_image.width) ? FRAME_TILE_SIZE : input_image.width - col;
+
+			if (!changed[i] && memcmp(input_pixels + col, previous_pixels + col, width) != 0) {
+				changed[i] = 1;
+				unchanged--;
+			}
+		}
+	}
+}
+
+// scales changed tiles of tile rows [first_tile_row, last_tile_row) into kept output, then copies them into kept input
+alt_u32 frameScaleTiles(
+		alt_sgdma_dev * transmit_DMA,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * receive_DMA,
+		volatile alt_u16 * rx_done_p,
+		JobBuffers_t *job_buffers,
+		Image_t input_image,
+		alt_u32 first_tile_row,
+		alt_u32 last_tile_row,
+		const alt_u8 *changed,
+		alt_u32 tile_cols) {
+
+	ScalingFactor_t scaling_factor = frame_sequence.scaling_factor;
+	IncreaseDecreaseResolution_t increase_decrease = frame_sequence.increase_decrease;
+	Image_t output_image = frame_sequence.output_image;
+	Image_t previous_image = frame_sequence.input_image;
+	ImagePartParameters_t part;
+	alt_u32 last_row = last_tile_row * FRAME_TILE_SIZE;
+
+	part.whole_part = PART;
+	part.row = first_tile_row * FRAME_TILE_SIZE;
+	part.height = ((last_row < input_image.height) ? last_row : input_image.height) - part.row;
+
+	for (alt_u32 first = 0, last; first < tile_cols; first = last) {
+		Image_t input_part = input_image;
+		Image_t output_part;
+
+		// run of changed tiles [first, last)
+		if (!changed[first]) {
+			last = first + 1;
+			continue;
+		}
+		for (last = first + 1; last < tile_cols && changed[last]; last++);
+		part.col = first * FRAME_TILE_SIZE;
+		part.width = ((last * FRAME_TILE_SIZE < input_image.width) ? last * FRAME_TILE_SIZE : input_image.width) - part.col;
+
+		// part of output is a view into kept output, as part of input is a view into input
+		if (formInputImage(part, &input_part) ||
+			outputImageSize(scaling_factor, increase_decrease, input_part, &output_part)) {
+			return 1;
+		}
+		output_part.stride = output_image.stride;
+		if (increase_decrease == INCREASE) {
+			output_part.pixels = output_image.pixels + part.row * scaling_factor * output_image.stride + part.col * scaling_factor;
+		} else {
+			output_part.pixels = output_image.pixels + part.row / scaling_factor * output_image.stride + part.col / scaling_factor;
+		}
+
+#if HOST_BUILD>0
+		(void)transmit_DMA;
+		(void)tx_done_p;
+		(void)receive_DMA;
+		(void)rx_done_p;
+		(void)job_buffers;
+		swProcessImage(scaling_factor, increase_decrease, input_part, output_part);
+#else
+		{
+			alt_sgdma_descriptor *m2s_desc;
+			alt_sgdma_descriptor *s2m_desc;
+
+			if (createDescriptors(&m2s_desc, &(job_buffers->m2s_descriptors), &s2m_desc, &(job_buffers->s2m_descriptors),
+								  input_part, output_part)) {
+				return 1;
+			}
+			dcacheFlushImage(input_part);
+			dcacheFlushImage(output_part);
+			if (hwProcessImage(transmit_DMA, m2s_desc, tx_done_p, receive_DMA, s2m_desc, rx_done_p,
+							   scaling_factor, increase_decrease, input_part, output_part, (BATCH_VALIDATE_RESULTS > 0))) {
+				return 1;
+			}
+		}
+#endif
+#if FUSED_PIPELINE==0
+		// point operation is not done by hw, only changed part of kept output goes through it
+		swPointOperationImage(&(frame_sequence.point_operation), output_part);
 #endif
-	// width
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_WIDTH_0, (alt_8)((input_image.width >> 0 ) & 0x000000FF));
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_WIDTH_1, (alt_8)((input_image.width >> 8 ) & 0x000000FF));
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_WIDTH_2, (alt_8)((input_image.width >> 16) & 0x000000FF));
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_WIDTH_3, (alt_8)((input_image.width >> 24) & 0x000000FF));
 
-	// height
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_HEIGHT_0, (alt_8)((input_image.height >> 0 ) & 0x000000FF));
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_HEIGHT_1, (alt_8)((input_image.height >> 8 ) & 0x000000FF));
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_HEIGHT_2, (alt_8)((input_image.height >> 16) & 0x000000FF));
-	IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_HEIGHT_3, (alt_8)((input_image.height >> 24) & 0x000000FF));
+		for (alt_u32 row = 0; row < input_part.height; row++) {
+			memcpy(previous_image.pixels + (part.row + row) * previous_image.stride + part.col,
+				   input_part.pixels + row * input_part.stride, input_part.width);
+		}
+		frame_tiles_changed += (alt_u64)(last - first) * (last_tile_row - first_tile_row);
+	}
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	scales frame of sequence, output_image is kept output with changed tiles scaled
+
+	work done for unchanged tile is only its comparison with kept input
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 frameProcessImage(
+		alt_sgdma_dev * transmit_DMA,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * receive_DMA,
+		volatile alt_u16 * rx_done_p,
+		JobBuffers_t *job_buffers,
+		Image_t input_image,
+		Image_t *output_image) {
+
+	alt_u32 tile_cols = (input_image.width + FRAME_TILE_SIZE - 1) / FRAME_TILE_SIZE;
+	alt_u32 tile_rows = (input_image.height + FRAME_TILE_SIZE - 1) / FRAME_TILE_SIZE;
+	alt_u32 first_tile_row = 0;
+	alt_u8 *changed;
+	alt_u8 *first_changed;		// changed tiles of first tile row of rows scaled together
+
+	if (reserveBuffer(&(job_buffers->frame_tiles), 2 * tile_cols)) {
+		return 1;
+	}
+	changed = (alt_u8*)job_buffers->frame_tiles.memory;
+	first_changed = changed + tile_cols;
+
+	// one more step after the last tile row scales the last rows
+	for (alt_u32 tile_row = 0; tile_row <= tile_rows; tile_row++) {
+		if (tile_row < tile_rows) {
+			frameChangedTiles(input_image, tile_row, changed, tile_cols);
+		}
+		if (tile_row > first_tile_row && (tile_row == tile_rows || memcmp(changed, first_changed, tile_cols) != 0)) {
+			if (frameScaleTiles(transmit_DMA, tx_done_p, receive_DMA, rx_done_p, job_buffers,
+								input_image, first_tile_row, tile_row, first_changed, tile_cols)) {
+				frameSequenceEnd();
+				return 1;
+			}
+			first_tile_row = tile_row;
+		}
+		if (tile_row == first_tile_row) {
+			memcpy(first_changed, changed, tile_cols);
+		}
+	}
+	frame_tiles += (alt_u64)tile_cols * tile_rows;
+	frame_sequence.frames++;
+	*output_image = frame_sequence.output_image;
+
+#if VERBOSE_LEVEL>0
+    printf("frameProcessImage end, frame %u\n", (unsigned int)frame_sequence.frames);
+#endif
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	parses one line of batch manifest file
+
+	line format (fields are separated by spaces or tabs):
+		{input filename} {scaling factor} {increase/decrease} 0 [{point operation}] {output filename}
+		{input filename} {scaling factor} {increase/decrease} 1 {row} {col} {width} {height} [{point operation}] {output filename}
+		{input filename} {scaling factor} {increase/decrease} frame [{point operation}] {output filename}
+	optional point operation (see parsePointOperation) is done on every pixel before scaling.
+	scaling factor "fit" and increase/decrease {width}x{height} make fit to box job, scaling is
+	planned when input size is known (see planFitToBox). scaling factor "pyramid" and
+	increase/decrease {levels} (1 to PYRAMID_LEVELS_MAX) make pyramid job, level k is 1/2^k of
+	input and goes to output filename with _2^k added (see pyramidLevelFilename). "frame" makes
+	frame job, whole image is scaled but only tiles changed since previous frame job are
+	processed (see frameProcessImage).
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 parseBatchJob(alt_8 *line, BatchJob_t *job) {
+	char *tokens[10];
+	alt_u32 tokens_count = 0;
+	char *token;
+	char *end;
+	unsigned long value;
+	alt_u32 *rect[4];
+
+	for (token = strtok((char*)line, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n")) {
+		if (tokens_count == 10) {
+			printf("ERROR: Too many fields in manifest line\n");
+			return 1;
+		}
+		tokens[tokens_count++] = token;
+	}
+
+	if (tokens_count < 5 || tokens_count == 7 || tokens_count == 8) {
+		printf("ERROR: Manifest line must have 5 or 6 (whole), 9 or 10 (part) fields\n");
+		return 1;
+	}
+
+	// input filename
+	if (strlen(tokens[0]) >= BATCH_FILENAME_MAX_LEN) {
+		printf("ERROR: Input filename exceeded maximum alowed lenght of %d characters\n", BATCH_FILENAME_MAX_LEN);
+		return 1;
+	}
+	strcpy((char*)job->input_filename, tokens[0]);
+
+	job->fit_width = 0;
+	job->fit_height = 0;
+	job->pyramid_levels = 0;
+	if (strcmp(tokens[1], "pyramid") == 0) {
+		// levels of pyramid
+		value = strtoul(tokens[2], &end, 10);
+		if (*end != '\0' || value < 1 || value > PYRAMID_LEVELS_MAX) {
+			printf("ERROR: Pyramid levels must be a number in range [1,%d]\n", PYRAMID_LEVELS_MAX);
+			return 1;
+		}
+		job->pyramid_levels = value;
+		job->scaling_factor = SF2;
+		job->increase_decrease = DECREASE;
+	} else if (strcmp(tokens[1], "fit") == 0) {
+		// box, scaling factor and increase/decrease are planned later
+		value = strtoul(tokens[2], &end, 10);
+		if (*end != 'x' || value == 0 || value > BIGGEST_32BIT_UNSIGNED_NUMBER) {
+			printf("ERROR: Fit to box needs box as {width}x{height}\n");
+			return 1;
+		}
+		job->fit_width = value;
+		value = strtoul(end + 1, &end, 10);
+		if (*end != '\0' || value == 0 || value > BIGGEST_32BIT_UNSIGNED_NUMBER) {
+			printf("ERROR: Fit to box needs box as {width}x{height}\n");
+			return 1;
+		}
+		job->fit_height = value;
+		job->scaling_factor = SCALING_FACTOR_MIN;
+		job->increase_decrease = DECREASE;
+	} else {
+		// scaling factor
+		value = strtoul(tokens[1], &end, 10);
+		if (*end != '\0' || value < SCALING_FACTOR_MIN || value > SCALING_FACTOR_MAX) {
+			printf("ERROR: Scaling factor must be a number in range [%d,%d]\n", SCALING_FACTOR_MIN, SCALING_FACTOR_MAX);
+			return 1;
+		}
+		job->scaling_factor = value;
+
+		// increase/decrease
+		value = strtoul(tokens[2], &end, 10);
+		if (*end != '\0' || (value != DECREASE && value != INCREASE)) {
+			printf("ERROR: increase/decrease must be %d or %d\n", DECREASE, INCREASE);
+			return 1;
+		}
+		job->increase_decrease = value;
+	}
+
+	// whole/part, frame is the whole image
+	job->frame = (strcmp(tokens[3], "frame") == 0);
+	value = job->frame ? WHOLE : strtoul(tokens[3], &end, 10);
+	if (!job->frame && (*end != '\0' || (value != WHOLE && value != PART))) {
+		printf("ERROR: whole/part must be %d, %d or frame\n", WHOLE, PART);
+		return 1;
+	}
+	if (job->frame && (job->fit_width > 0 || job->pyramid_levels > 0)) {
+		printf("ERROR: Frame job needs scaling factor and increase/decrease\n");
+		return 1;
+	}
+	job->image_part_parameters.whole_part = value;
+
+	if ((job->image_part_parameters.whole_part == WHOLE) != (tokens_count < 9)) {
+		printf("ERROR: Part of image needs row, col, width and height, whole image does not\n");
+		return 1;
+	}
+
+	// row, col, width, height
+	if (job->image_part_parameters.whole_part == PART) {
+		rect[0] = &(job->image_part_parameters.row);
+		rect[1] = &(job->image_part_parameters.col);
+		rect[2] = &(job->image_part_parameters.width);
+		rect[3] = &(job->image_part_parameters.height);
+		for (alt_u32 i = 0; i < 4; i++) {
+			value = strtoul(tokens[4 + i], &end, 10);
+			if (*end != '\0' || value > BIGGEST_32BIT_UNSIGNED_NUMBER) {
+				printf("ERROR: Part of image parameters must be unsigned 32bit numbers\n");
+				return 1;
+			}
+			*(rect[i]) = value;
+		}
+	}
+
+	// point operation
+	job->point_operation.type = POINT_NONE;
+	if (tokens_count == 6 || tokens_count == 10) {
+		if (parsePointOperation(tokens[tokens_count - 2], &(job->point_operation))) {
+			return 1;
+		}
+	}
+
+	// output filename
+	if (strlen(tokens[tokens_count - 1]) >= BATCH_FILENAME_MAX_LEN) {
+		printf("ERROR: Output filename exceeded maximum alowed lenght of %d characters\n", BATCH_FILENAME_MAX_LEN);
+		return 1;
+	}
+	strcpy((char*)job->output_filename, tokens[tokens_count - 1]);
+
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	streams opened input image through processing in bands of rows
+
+	only one band of input rows and its output rows are held in memory at a time, so images
+	bigger than the memory can be processed. band height is a multiple of scaling factor so every
+	band starts on a row that is kept on decrease. output file has the same format as the one
+	written by storeImage.
+	input_image holds width and height read by openImage, on return input_image and output_image
+	hold width and height of processed part of image and of the whole output image.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 streamImage(
+		FILE *ptr_input_file,
+		BatchJob_t *job,
+		alt_8 *output_filename,
+		JobBuffers_t *job_buffers,
+		Image_t *input_image,
+		Image_t *output_image,
+		alt_sgdma_dev * sgdma_m2s,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * sgdma_s2m,
+		volatile alt_u16 * rx_done_p) {
+
+	FILE *ptr_output_file;
+	Image_t band_input_image;
+	Image_t band_output_image;
+	alt_u32 file_width = input_image->width;
+	alt_u32 first_row = 0;
+	alt_u32 first_col = 0;
+	alt_u32 scale = job->scaling_factor;
+	alt_u32 group_size;
+	alt_u32 band_rows;
+#if HOST_BUILD==0
+	alt_sgdma_descriptor *m2s_desc;
+	alt_sgdma_descriptor *s2m_desc;
+#else
+	(void)sgdma_m2s;
+	(void)tx_done_p;
+	(void)sgdma_s2m;
+	(void)rx_done_p;
+#endif
+
+	// part of image that needs to be processed
+	if (job->image_part_parameters.whole_part == PART) {
+		if (job->image_part_parameters.row + job->image_part_parameters.height > input_image->height) {
+			printf("ERROR: Part of image rows exceed input image\n");
+			return 1;
+		}
+		if (job->image_part_parameters.col + job->image_part_parameters.width > input_image->width) {
+			printf("ERROR: Part of image columns exceed input image\n");
+			return 1;
+		}
+		first_row = job->image_part_parameters.row;
+		first_col = job->image_part_parameters.col;
+		input_image->width = job->image_part_parameters.width;
+		input_image->height = job->image_part_parameters.height;
+	}
+
+	if (outputImageSize(job->scaling_factor, job->increase_decrease, *input_image, output_image)) {
+		return 1;
+	}
+
+	// band height: as many groups of "scale" input rows as fit into streaming buffer
+	// together with the output rows they produce
+	if (job->increase_decrease == INCREASE) {
+		group_size = scale * file_width + scale * scale * output_image->width;
+	} else {
+		group_size = scale * file_width + output_image->width;
+	}
+	band_rows = (STREAMING_BUFFER_SIZE / group_size) * scale;
+	if (band_rows == 0) {
+		band_rows = scale;
+	}
+#if VERBOSE_LEVEL>0
+    printf("streamImage: %u rows per band\n", (unsigned int)band_rows);
+#endif
+
+	// input band buffer holds whole rows of the file, part of image is a view into it
+	if (reserveBuffer(&(job_buffers->input_image), band_rows * file_width)) {
+		return 1;
+	}
+
+	// skip rows above part of image
+	if (first_row > 0 && fseek(ptr_input_file, (long)first_row * file_width, SEEK_CUR)) {
+		printf("ERROR: Unable to seek in input file\n");
+		return 1;
+	}
+
+    // open output file and write output image width and height
+    ptr_output_file = fopen((char*)output_filename,"wb");
+    if (ptr_output_file == NULL)
+    {
+        printf("Unable to open file \"%s\"!\n", output_filename);
+        return 1;
+    }
+    if (writeBlock(ptr_output_file, &(output_image->width), sizeof(output_image->width)) ||
+		writeBlock(ptr_output_file, &(output_image->height), sizeof(output_image->height))) {
+		printf("ERROR: Unable to write file \"%s\"!\n", output_filename);
+		fclose(ptr_output_file);
+		return 1;
+	}
+
+	for (alt_u32 row = 0; row < input_image->height; row += band_rows) {
+		// read band of input rows
+		band_input_image.width = input_image->width;
+		band_input_image.height = (input_image->height - row < band_rows) ? input_image->height - row : band_rows;
+		band_input_image.stride = file_width;
+		band_input_image.pixels = (alt_u8*)job_buffers->input_image.memory + first_col;
+		if (readBlock(ptr_input_file, job_buffers->input_image.memory, (alt_u64)band_input_image.height * file_width)) {
+			printf("ERROR: Input file is shorter than its width and height require\n");
+			fclose(ptr_output_file);
+			return 1;
+		}
+
+		if (formOutputImage(job->scaling_factor, job->increase_decrease, band_input_image, &band_output_image, &(job_buffers->output_image))) {
+			fclose(ptr_output_file);
+			return 1;
+		}
+
+		// process band
+#if HOST_BUILD>0
+		PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+		if ((HOST_ACC_SCALE_MODEL > 0) ?
+				multiProcessImage(job_buffers, job->scaling_factor, job->increase_decrease, band_input_image, band_output_image, 0) :
+				swProcessImageParallel(job->scaling_factor, job->increase_decrease, band_input_image, band_output_image, 0)) {
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+			fclose(ptr_output_file);
+			return 1;
+		}
+		PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+#else
+		if (acc_scale_instances_count > 1) {
+			// bands of the band on all the instances
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			if (multiProcessImage(job_buffers, job->scaling_factor, job->increase_decrease, band_input_image, band_output_image,
+								  (BATCH_VALIDATE_RESULTS > 0))) {
+				PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+				fclose(ptr_output_file);
+				return 1;
+			}
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+		} else {
+			if (createDescriptors(&m2s_desc, &(job_buffers->m2s_descriptors), &s2m_desc, &(job_buffers->s2m_descriptors), band_input_image, band_output_image)) {
+				fclose(ptr_output_file);
+				return 1;
+			}
+
+			dcacheFlushImage(band_input_image);
+			dcacheFlushImage(band_output_image);
+
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			if (hwProcessImage(
+					sgdma_m2s,
+					m2s_desc,
+					tx_done_p,
+					sgdma_s2m,
+					s2m_desc,
+					rx_done_p,
+					job->scaling_factor,
+					job->increase_decrease,
+					band_input_image,
+					band_output_image,
+					(BATCH_VALIDATE_RESULTS > 0))) {
+				PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+				fclose(ptr_output_file);
+				return 1;
+			}
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+		}
+#endif
+#if FUSED_PIPELINE==0
+		// point operation is not done by hw, second pass over output band
+		PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+		swPointOperationImage(&(job->point_operation), band_output_image);
+		PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+#endif
+
+		// write band of output rows
+		if (writeBlock(ptr_output_file, band_output_image.pixels, (alt_u64)band_output_image.width * band_output_image.height)) {
+			printf("ERROR: Unable to write file \"%s\"!\n", output_filename);
+			fclose(ptr_output_file);
+			return 1;
+		}
+	}
+
+    // close output file, buffered data is written by fclose
+    if (fclose(ptr_output_file) != 0) {
+        printf("ERROR: Unable to write file \"%s\"!\n", output_filename);
+        return 1;
+    }
+
+#if VERBOSE_LEVEL>0
+    printf("streamImage end.\n");
+#endif
+	return 0;
+}
+
+/*
+	------------------------------------------------------------------------------------------------
+	runs all the jobs from batch manifest file utilising hw accelerator
+
+	image, descriptor buffers and sgdma callbacks are set up once and reused by all the jobs.
+	inputs with at least STREAMING_MIN_INPUT_SIZE pixels are streamed in bands (see streamImage).
+	aggregate throughput of the accelerator and of the whole batch is printed at the end.
+	host build uses software processing instead of hw accelerator.
+	------------------------------------------------------------------------------------------------
+*/
+alt_u32 runBatch(
+		alt_8 *manifest_filename,
+		JobBuffers_t *job_buffers,
+		alt_sgdma_dev * sgdma_m2s,
+		volatile alt_u16 * tx_done_p,
+		alt_sgdma_dev * sgdma_s2m,
+		volatile alt_u16 * rx_done_p) {
+
+	FILE *ptr_manifest_file;
+	FILE *ptr_input_file;
+	alt_8 manifest_filename_nios[PATH_MAX_LEN];
+	alt_8 output_filename_nios[PATH_MAX_LEN];
+	alt_8 line[BATCH_LINE_MAX_LEN];
+	alt_u32 line_number = 0;
+	alt_u32 jobs_done = 0;
+	alt_u32 jobs_failed = 0;
+	alt_u64 input_pixels = 0;
+	alt_u64 output_pixels = 0;
+	alt_u64 hw_cycles;
+	alt_u64 total_cycles;
+
+	BatchJob_t job;
+	FitPlan_t fit_plan;
+	Image_t input_image;
+	Image_t output_image;
+
+	if (strlen((char*)manifest_filename) + sizeof(INPUT_DIRECTORY) > PATH_MAX_LEN) {
+		printf("ERROR: Manifest filename \"%s\" is too long\n", manifest_filename);
+		return 1;
+	}
+	strcpy((char*)manifest_filename_nios, INPUT_DIRECTORY);
+	strcat((char*)manifest_filename_nios, (char*)manifest_filename);
+
+	ptr_manifest_file = fopen((char*)manifest_filename_nios, "r");
+	if (ptr_manifest_file == NULL) {
+		printf("ERROR: Unable to open file \"%s\"!\n", manifest_filename);
+		return 1;
+	}
+
+#if HOST_BUILD==0
+	// callbacks are registered once for all the jobs
+	alt_avalon_sgdma_register_callback(
+			sgdma_m2s,
+			&transmit_callback_function,
+			(ALTERA_AVALON_SGDMA_CONTROL_IE_GLOBAL_MSK |
+			 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
+			 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
+			(void*)tx_done_p);
+	alt_avalon_sgdma_register_callback(
+			sgdma_s2m,
+			&receive_callback_function,
+			(ALTERA_AVALON_SGDMA_CONTROL_IE_GLOBAL_MSK |
+			 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
+			 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
+			(void*)rx_done_p);
+#endif
+
+	// section 1 counts scaling only, global counter counts the whole batch
+	PERF_RESET(PERFORMANCE_COUNTER_BASE);
+	PERF_START_MEASURING(PERFORMANCE_COUNTER_BASE);
+	memset(&io_read_statistics, 0, sizeof(IoStatistics_t));
+	memset(&io_write_statistics, 0, sizeof(IoStatistics_t));
+	frame_tiles = 0;
+	frame_tiles_changed = 0;
+
+	while (fgets((char*)line, BATCH_LINE_MAX_LEN, ptr_manifest_file) != NULL) {
+		alt_u32 i;
+
+		line_number++;
+
+		// skip empty lines and comments
+		for (i = 0; isspace((int)line[i]); i++);
+		if (line[i] == '\0' || line[i] == '#') {
+			continue;
+		}
+
+		if (parseBatchJob(line, &job)) {
+			printf("ERROR: Batch job at line %u skipped\n", (unsigned int)line_number);
+			jobs_failed++;
+			continue;
+		}
+
+		// frame sequence goes on only with the next frame of the same size and scaling
+		if (!frameSequenceContinues(&job)) {
+			frameSequenceEnd();
+		}
+
+		// memory of previous job is given back at once (kept frame stays)
+		resetJobBuffers(job_buffers);
+		if (job.frame && frameSequenceStart(&job)) {
+			printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+			jobs_failed++;
+			continue;
+		}
+
+		// fit to box job: acc_scale stage of the cheapest plan is the scaling of the job
+		memset(&fit_plan, 0, sizeof(fit_plan));
+		fit_plan.hw_stage = 1;
+		if (job.fit_width > 0) {
+			if (batchJobInputSize(&job, &input_image) ||
+				planFitToBox(input_image, job.fit_width, job.fit_height, &fit_plan)) {
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+			if (fit_plan.hw_stage) {
+				job.scaling_factor = fit_plan.scaling_factor;
+				job.increase_decrease = fit_plan.increase_decrease;
+			}
+		}
+
+#if HOST_BUILD==0
+		// first job of every scaling measures hw and sw speed for hybrid processing
+		if (fit_plan.hw_stage && job.pyramid_levels == 0 && !job.frame &&
+			calibrateHybrid(sgdma_m2s, tx_done_p, sgdma_s2m, rx_done_p, job_buffers, job.scaling_factor, job.increase_decrease)) {
+			printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+			jobs_failed++;
+			continue;
+		}
+
+		// point operation of the job in acc_linear_function (if chained in front of acc_scale)
+		hwSetPointOperation(&(job.point_operation));
+#endif
+
+#if VERBOSE_LEVEL>0
+		printf("Batch job at line %u: %s %d %d -> %s\n", (unsigned int)line_number, job.input_filename,
+				job.scaling_factor, job.increase_decrease, job.output_filename);
+#endif
+
+		if (strlen((char*)job.output_filename) + sizeof(OUTPUT_DIRECTORY) > PATH_MAX_LEN) {
+			printf("ERROR: Output filename \"%s\" is too long\n", job.output_filename);
+			jobs_failed++;
+			continue;
+		}
+		strcpy((char*)output_filename_nios, OUTPUT_DIRECTORY);
+		strcat((char*)output_filename_nios, (char*)job.output_filename);
+
+		if (isTiledImage(job.input_filename)) {
+			// only tiles overlapping part of image are read, part of image is applied while loading
+			if (loadTiledImage(job.input_filename, job.image_part_parameters, &input_image,
+							   &(job_buffers->input_image), &(job_buffers->tiles))) {
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+		} else {
+			ptr_input_file = openImage(job.input_filename, &input_image);
+			if (ptr_input_file == NULL) {
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+
+			// big images are streamed in bands of rows straight into output file (unless resized after scaling)
+			if ((alt_u64)input_image.width * input_image.height >= STREAMING_MIN_INPUT_SIZE &&
+				!isTiledImage(job.output_filename) && fit_plan.hw_stage && !fit_plan.residual && job.pyramid_levels == 0 && !job.frame) {
+				alt_u32 result = streamImage(
+						ptr_input_file,
+						&job,
+						output_filename_nios,
+						job_buffers,
+						&input_image,
+						&output_image,
+						sgdma_m2s,
+						tx_done_p,
+						sgdma_s2m,
+						rx_done_p);
+				fclose(ptr_input_file);
+				if (result) {
+					printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+					jobs_failed++;
+					continue;
+				}
+
+				jobs_done++;
+				input_pixels += (alt_u64)input_image.width * input_image.height;
+				output_pixels += (alt_u64)output_image.width * output_image.height;
+				continue;
+			}
+
+			// small images are loaded whole
+	#if HOST_BUILD>0
+			fclose(ptr_input_file);
+			if (loadImage(job.input_filename, &input_image, &(job_buffers->input_image))) {
+	#else
+			if (readImage(ptr_input_file, &input_image, &(job_buffers->input_image))) {
+				fclose(ptr_input_file);
+	#endif
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+	#if HOST_BUILD==0
+			fclose(ptr_input_file);
+	#endif
+
+			if (formInputImage(job.image_part_parameters, &input_image)) {
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+		}
+
+		// pyramid job stores its levels itself
+		if (job.pyramid_levels > 0) {
+			if (pyramidJob(&job, output_filename_nios, job_buffers, input_image, &output_pixels)) {
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+			jobs_done++;
+			input_pixels += (alt_u64)input_image.width * input_image.height;
+			continue;
+		}
+
+		if (job.frame) {
+			// only changed tiles are scaled (and go through point operation)
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			if (frameProcessImage(sgdma_m2s, tx_done_p, sgdma_s2m, rx_done_p, job_buffers, input_image, &output_image)) {
+				PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+		} else if (fit_plan.hw_stage) {
+			if (formOutputImage(job.scaling_factor, job.increase_decrease, input_image, &output_image, &(job_buffers->output_image))) {
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+
+#if HOST_BUILD>0
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			if ((HOST_ACC_SCALE_MODEL > 0) ?
+					multiProcessImage(job_buffers, job.scaling_factor, job.increase_decrease, input_image, output_image, 0) :
+					swProcessImageParallel(job.scaling_factor, job.increase_decrease, input_image, output_image, 0)) {
+				PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+#else
+			// bands on all acc_scale instances, with one instance top rows on hw and the rest on NIOS
+			// meanwhile (all rows on hw if hybrid processing is off)
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			if ((acc_scale_instances_count > 1) ?
+					multiProcessImage(job_buffers, job.scaling_factor, job.increase_decrease, input_image, output_image,
+									  (BATCH_VALIDATE_RESULTS > 0)) :
+					hybridProcessImage(
+					sgdma_m2s,
+					tx_done_p,
+					sgdma_s2m,
+					rx_done_p,
+					job_buffers,
+					job.scaling_factor,
+					job.increase_decrease,
+					input_image,
+					output_image,
+					(BATCH_VALIDATE_RESULTS > 0))) {
+				PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+#endif
+		} else {
+			output_image = input_image;
+		}
+
+		// residual resize of fit to box job
+		if (fit_plan.residual) {
+			Image_t resized_image;
+
+			resized_image.width = fit_plan.width;
+			resized_image.height = fit_plan.height;
+			if (allocateImage(&resized_image, &(job_buffers->resized_image))) {
+				printf("ERROR: Unable to allocate buffer for resized image.\n");
+				printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+				jobs_failed++;
+				continue;
+			}
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			swResizeImage(output_image, resized_image);
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+			output_image = resized_image;
+		}
+
+#if FUSED_PIPELINE==0
+		// point operation is not done by hw, second pass over output image
+		if (!job.frame) {
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			swPointOperationImage(&(job.point_operation), output_image);
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+		}
+#else
+		if (!fit_plan.hw_stage) {
+			// acc_linear_function is skipped together with acc_scale
+			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
+			swPointOperationImage(&(job.point_operation), output_image);
+			PERF_END(PERFORMANCE_COUNTER_BASE, 1);
+		}
+#endif
+
+		if (isTiledImage(job.output_filename) ?
+				storeTiledImage(output_filename_nios, output_image, &(job_buffers->tiles)) :
+				storeImage(output_filename_nios, output_image)) {
+			printf("ERROR: Batch job at line %u failed\n", (unsigned int)line_number);
+			jobs_failed++;
+			continue;
+		}
+
+		jobs_done++;
+		input_pixels += (alt_u64)input_image.width * input_image.height;
+		output_pixels += (alt_u64)output_image.width * output_image.height;
+	}
+
+	PERF_STOP_MEASURING(PERFORMANCE_COUNTER_BASE);
+	fclose(ptr_manifest_file);
+	frameSequenceEnd();
+
+	// ----------------------------------------------------------------
+	// printing aggregate report
+	// ----------------------------------------------------------------
+	hw_cycles = perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 1);
+	total_cycles = perf_get_total_time((void*)PERFORMANCE_COUNTER_BASE);
+
+	printf("Batch jobs done:    %u\n", (unsigned int)jobs_done);
+	printf("Batch jobs failed:  %u\n", (unsigned int)jobs_failed);
+	printf("Input pixels:       %llu\n", (unsigned long long)input_pixels);
+	printf("Output pixels:      %llu\n", (unsigned long long)output_pixels);
+	if (hw_cycles > 0) {
+		printf("%s throughput:      %llu input pixels/s, %llu output pixels/s\n", (HOST_BUILD>0) ? "SW" : "HW",
+				(unsigned long long)(input_pixels * alt_get_cpu_freq() / hw_cycles),
+				(unsigned long long)(output_pixels * alt_get_cpu_freq() / hw_cycles));
+	}
+	if (total_cycles > 0) {
+		printf("Batch throughput:   %llu input pixels/s, %llu jobs/min\n",
+				(unsigned long long)(input_pixels * alt_get_cpu_freq() / total_cycles),
+				(unsigned long long)((alt_u64)jobs_done * 60 * alt_get_cpu_freq() / total_cycles));
+	}
+	if (frame_tiles > 0) {
+		printf("Frame tiles:        %llu changed of %llu\n", (unsigned long long)frame_tiles_changed, (unsigned long long)frame_tiles);
+	}
+	printIoReport();
+	if (acc_scale_instances_count > 1) {
+		printAccScaleReport();
+	}
+
+	return (jobs_failed > 0);
+}
+
+#if HOST_BUILD>0
+/*
+	------------------------------------------------------------------------------------------------
+	measures software scaling of 4K and 8K frames with 1 to all cores (host build only)
 
-	// status is read only
+	every case is run SW_BENCHMARK_RUNS times and the best time is reported, result of every
+	run is checked against CRC32 of swProcessImageReference result
+	------------------------------------------------------------------------------------------------
+*/
+#define SW_BENCHMARK_RUNS 		3
 
-	// control
-	if (increase_decrease == INCREASE) {
-#if VERBOSE_LEVEL>0
-		printf("control: %02x\n", (unsigned int)(BIT_CONTROL_START + BIT_CONTROL_INCREASE + scaling_factor));
-#endif
-		IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_CONTROL, (unsigned char)(BIT_CONTROL_START + BIT_CONTROL_INCREASE + scaling_factor));
-	} else {
-#if VERBOSE_LEVEL>0
-		printf("control: %02x\n", (unsigned int)(BIT_CONTROL_START + scaling_factor));
-#endif
-		IOWR_8DIRECT(ACC_SCALE_BASE, ADDR_CONTROL, (unsigned char)(BIT_CONTROL_START + scaling_factor));
-	}
+// places pseudo random input frame and output image of the scaling into job buffers
+static alt_u32 formBenchmarkImages(
+		JobBuffers_t *job_buffers,
+		alt_u32 width,
+		alt_u32 height,
+		ScalingFactor_t scaling_factor,
+		IncreaseDecreaseResolution_t increase_decrease,
+		Image_t *input_image,
+		Image_t *output_image) {
 
-	// Starting both the transmit and receive transfers
+	resetJobBuffers(job_buffers);
 
-#if VERBOSE_LEVEL>0
-    printf("Starting up the SGDMA engines\n");
-#endif
-	// Start non blocking transfer with DMA modules.
-	if(alt_avalon_sgdma_do_async_transfer(transmit_DMA, &transmit_descriptors[0]) != 0) {
-		printf("Writing the head of the transmit descriptor list to the DMA failed\n");
+	input_image->width = width;
+	input_image->height = height;
+	if (allocateImage(input_image, &(job_buffers->input_image))) {
 		return 1;
 	}
-	if(alt_avalon_sgdma_do_async_transfer(receive_DMA, &receive_descriptors[0]) != 0) {
-		printf("Writing the head of the receive descriptor list to the DMA failed\n");
-		return 1;
+	for (alt_u32 i = 0; i < width * height; i++) {
+		input_image->pixels[i] = (alt_u8)((i * 2654435761u) >> 24);
 	}
+	return formOutputImage(scaling_factor, increase_decrease, *input_image, output_image, &(job_buffers->output_image));
+}
 
-	// Blocking until the SGDMA interrupts fire
-	while(*tx_done_p < 1) {}
-#if VERBOSE_LEVEL>0
-	printf("The transmit SGDMA has completed\n");
-#endif
-	while(*rx_done_p < 1) {}
-#if VERBOSE_LEVEL>0
-	printf("The receive SGDMA has completed\n");
-#endif
+alt_u32 runSwBenchmark(JobBuffers_t *job_buffers) {
+	const alt_u32 frame_sizes[][2] = { {3840, 2160}, {7680, 4320} };
+	const IncreaseDecreaseResolution_t directions[] = { INCREASE, DECREASE };
+	alt_u32 cores = (HOST_SW_THREADS > 0) ? HOST_SW_THREADS : hostCoresCount();
+	Image_t input_image;
+	Image_t output_image;
 
-	*tx_done_p = 0;
-	*rx_done_p = 0;
+	printf("SW benchmark, %u cores, %s row kernels, best of %u runs\n", (unsigned int)cores, swRowKernels()->name, SW_BENCHMARK_RUNS);
+	printf("%-12s %-10s %8s %12s %12s %8s\n", "Frame", "Scaling", "Threads", "Time [ms]", "Mpix/s", "Speedup");
 
-	// Stop the SGDMAs
-	alt_avalon_sgdma_stop(transmit_DMA);
-	alt_avalon_sgdma_stop(receive_DMA);
+	for (alt_u32 f = 0; f < sizeof(frame_sizes) / sizeof(frame_sizes[0]); f++) {
+		for (alt_u32 d = 0; d < sizeof(directions) / sizeof(directions[0]); d++) {
+			if (formBenchmarkImages(job_buffers, frame_sizes[f][0], frame_sizes[f][1], SF2, directions[d], &input_image, &output_image)) {
+				return 1;
+			}
 
-#if VERBOSE_LEVEL>0
-	printf("hwProcessImage end\n");
-#endif
+			if (swProcessImageReference(SF2, directions[d], input_image, output_image)) {
+				return 1;
+			}
+			alt_u32 expected_crc = crc32Image(output_image);
+			alt_u64 output_pixels = (alt_u64)output_image.width * output_image.height;
+			alt_u64 single_thread_time = 0;
+
+			for (alt_u32 threads = 1; threads <= cores; threads = (threads * 2 > cores && threads < cores) ? cores : threads * 2) {
+				alt_u64 best_time = 0;
+
+				for (alt_u32 run = 0; run < SW_BENCHMARK_RUNS; run++) {
+					memset(output_image.pixels, 0, output_pixels);
+					alt_u64 start = hostTimeNs();
+					if (swProcessImageParallel(SF2, directions[d], input_image, output_image, threads)) {
+						return 1;
+					}
+					alt_u64 time = hostTimeNs() - start;
+					if (crc32Image(output_image) != expected_crc) {
+						printf("ERROR: SW benchmark result of %u threads differs from swProcessImageReference\n", (unsigned int)threads);
+						return 1;
+					}
+					if (run == 0 || time < best_time) {
+						best_time = time;
+					}
+				}
+				if (threads == 1) {
+					single_thread_time = best_time;
+				}
+				if (best_time == 0) {
+					best_time = 1;
+				}
+
+				printf("%5ux%-6u %-10s %8u %12.2f %12.1f %7.2fx\n",
+						(unsigned int)input_image.width, (unsigned int)input_image.height,
+						(directions[d] == INCREASE) ? "x2 up" : "x2 down",
+						(unsigned int)threads,
+						best_time / 1e6,
+						output_pixels * 1e3 / best_time,
+						(double)single_thread_time / best_time);
+			}
+		}
+	}
+	resetJobBuffers(job_buffers);
 	return 0;
 }
 
 /*
 	------------------------------------------------------------------------------------------------
-	validate hw results that are in output image
-	
-	same as swProcessImage, instead of writing data to output image just compare data
+	measures single threaded swProcessImageTiled over tile sizes and frame sizes (host build only)
+
+	tile 0x0 is whole rows (no tiling). cache misses are counted by linux perf events when
+	kernel allows it, otherwise n/a is printed.
 	------------------------------------------------------------------------------------------------
 */
-alt_u32 validateResultsHW(
-        ScalingFactor_t scaling_factor,
-        IncreaseDecreaseResolution_t increase_decrease,
-        Image_t input_image,
-        Image_t output_image) {
+static int hostCacheMissesOpen() {
+#if defined(__linux__)
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
 
-    if (increase_decrease == INCREASE) {
-        alt_u32 col_mul_cnt = 0;
-        alt_u32 row_mul_cnt = 0;
-        alt_u32 in_row = 0;
-        alt_u32 in_col = 0;
-        for(alt_u32 out_row = 0; out_row < output_image.height; out_row++) {
-			for(alt_u32 out_col = 0; out_col < output_image.width; out_col++) {
-				if ( (output_image.pixels)[out_row][out_col] != (input_image.pixels)[in_row][in_col] ) {
-					// mismatch => hw results are not good
-					printf("ValidateResultsHW: FAIL at pixel [%u,%u]\n", (unsigned int)out_row, (unsigned int)out_col);
-					return 0;
-				}
+alt_u32 runSwTileBenchmark(JobBuffers_t *job_buffers) {
+	const alt_u32 frame_sizes[][2] = { {1920, 1080}, {3840, 2160}, {7680, 4320} };
+	const ScalingFactor_t scaling_factors[] = { SF2, SF4 };
+	const IncreaseDecreaseResolution_t directions[] = { INCREASE, DECREASE };
+	const alt_u32 tile_sizes[][2] = { {0, 0}, {32, 32}, {64, 64}, {128, 128}, {256, 256}, {1024, 16} };
+	int cache_misses_fd = hostCacheMissesOpen();
+	Image_t input_image;
+	Image_t output_image;
+	alt_8 text[32];
+	alt_8 scaling[16];
 
-				col_mul_cnt++;
+	printf("SW tile benchmark, %s row kernels, 1 thread, best of %u runs\n", swRowKernels()->name, SW_BENCHMARK_RUNS);
+	printf("%-12s %-10s %10s %12s %12s %14s\n", "Frame", "Scaling", "Tile", "Time [ms]", "Mpix/s", "Cache misses");
 
-				if (col_mul_cnt == scaling_factor) {
-					col_mul_cnt = 0;
-					in_col++;
+	for (alt_u32 f = 0; f < sizeof(frame_sizes) / sizeof(frame_sizes[0]); f++) {
+		for (alt_u32 d = 0; d < sizeof(directions) / sizeof(directions[0]); d++) {
+			if (formBenchmarkImages(job_buffers, frame_sizes[f][0], frame_sizes[f][1], scaling_factors[d], directions[d], &input_image, &output_image)) {
+				close(cache_misses_fd);
+				return 1;
+			}
 
-					if (in_col == input_image.width) {
-						in_col = 0;
-						row_mul_cnt++;
+			if (swProcessImageReference(scaling_factors[d], directions[d], input_image, output_image)) {
+				close(cache_misses_fd);
+				return 1;
+			}
+			alt_u32 expected_crc = crc32Image(output_image);
+			alt_u64 output_pixels = (alt_u64)output_image.width * output_image.height;
 
-						if (row_mul_cnt == scaling_factor) {
-							row_mul_cnt = 0;
-							in_row++;
+			for (alt_u32 t = 0; t < sizeof(tile_sizes) / sizeof(tile_sizes[0]); t++) {
+				alt_u64 best_time = 0;
+				long long best_misses = -1;
+
+				for (alt_u32 run = 0; run < SW_BENCHMARK_RUNS; run++) {
+					long long misses = -1;
+
+					memset(output_image.pixels, 0, output_pixels);
+					if (cache_misses_fd >= 0) {
+						ioctl(cache_misses_fd, PERF_EVENT_IOC_RESET, 0);
+						ioctl(cache_misses_fd, PERF_EVENT_IOC_ENABLE, 0);
+					}
+					alt_u64 start = hostTimeNs();
+					swProcessImageTiled(scaling_factors[d], directions[d], input_image, output_image, tile_sizes[t][0], tile_sizes[t][1]);
+					alt_u64 time = hostTimeNs() - start;
+					if (cache_misses_fd >= 0) {
+						ioctl(cache_misses_fd, PERF_EVENT_IOC_DISABLE, 0);
+						if (read(cache_misses_fd, &misses, sizeof(misses)) != sizeof(misses)) {
+							misses = -1;
 						}
 					}
+
+					if (crc32Image(output_image) != expected_crc) {
+						printf("ERROR: SW tile benchmark result of tile %ux%u differs from swProcessImageReference\n",
+								(unsigned int)tile_sizes[t][0], (unsigned int)tile_sizes[t][1]);
+						close(cache_misses_fd);
+						return 1;
+					}
+					if (run == 0 || time < best_time) {
+						best_time = time;
+					}
+					if (best_misses < 0 || (misses >= 0 && misses < best_misses)) {
+						best_misses = misses;
+					}
 				}
-			}
-        }
-    } else {
-        alt_u32 in_row = 0;
-        alt_u32 in_col = 0;
-		for(alt_u32 out_row = 0; out_row < output_image.height; out_row++) {
-			for(alt_u32 out_col = 0; out_col < output_image.width; out_col++) {
-				if ( (output_image.pixels)[out_row][out_col] != (input_image.pixels)[in_row][in_col] ) {
-					// mismatch => hw results are not good
-					printf("ValidateResultsHW: FAIL at pixel [%u,%u]\n", (unsigned int)out_row, (unsigned int)out_col);
-					return 0;
+				if (best_time == 0) {
+					best_time = 1;
 				}
 
-				if (in_col >= input_image.width - scaling_factor) {
-					in_row += scaling_factor;
-					in_col = 0;
+				if (best_misses >= 0) {
+					sprintf((char*)text, "%lld", best_misses);
 				} else {
-					in_col += scaling_factor;
+					strcpy((char*)text, "n/a");
 				}
+				sprintf((char*)scaling, "%s%u %s", (directions[d] == INCREASE) ? "x" : "/",
+						(unsigned int)scaling_factors[d], (directions[d] == INCREASE) ? "up" : "down");
+				printf("%5ux%-6u %-10s %4ux%-5u %12.2f %12.1f %14s\n",
+						(unsigned int)input_image.width, (unsigned int)input_image.height,
+						scaling,
+						(unsigned int)tile_sizes[t][0], (unsigned int)tile_sizes[t][1],
+						best_time / 1e6,
+						output_pixels * 1e3 / best_time,
+						text);
 			}
 		}
-    }
-
-	printf("ValidateResultsHW: SUCCESS!\n");
-    return 0;
-}
-
-/*
-	------------------------------------------------------------------------------------------------
-	main
-	------------------------------------------------------------------------------------------------
-*/
-
-// s2m sgdma interrupt
-void transmit_callback_function(void * context)
-{
-	alt_u16 *tx_done = (alt_u16*) context;
-	(*tx_done)++;  /* main will be polling for this value being 1 */
-}
-
-void receive_callback_function(void * context)
-{
-	alt_u16 *rx_done = (alt_u16*) context;
-	(*rx_done)++;  /* main will be polling for this value being 1 */
+	}
+	if (cache_misses_fd >= 0) {
+		close(cache_misses_fd);
+	}
+	resetJobBuffers(job_buffers);
+	return 0;
 }
+#endif
 
 int main () {
-	/* Since descriptors need to be placed in memory locations aligned to
-	 * descriptor size (which is 4 bytes), larger chunk of memory is first allocated
-	 * and then aligned location is found. Descriptor pointers point to descriptors
-	 * placed on aligned location and copy pointer points to entire allocated memory.
-	 * Copy pointers are needed for properly freeing of allocated memory. */
-	alt_sgdma_descriptor *m2s_desc, *m2s_desc_copy;
-	alt_sgdma_descriptor *s2m_desc, *s2m_desc_copy;
+	/* Images and descriptors of a job are taken from job arena, which is allocated
+	 * once and aligned to DMA_BUFFER_ALIGNMENT (sgdma descriptors need 32 byte
+	 * alignment). Arena is given back in one step before every job and freed when
+	 * the program exits. */
+	JobBuffers_t job_buffers;
+
+#if HOST_BUILD>0
+	// there is no SG-DMA on host
+	alt_sgdma_dev * sgdma_m2s = NULL;
+	alt_sgdma_dev * sgdma_s2m = NULL;
+#else
+	alt_sgdma_descriptor *m2s_desc;
+	alt_sgdma_descriptor *s2m_desc;
 
 	// Open a SG-DMA for MM-->ST and ST-->MM (two SG-DMAs are present)
 	alt_sgdma_dev * sgdma_m2s = alt_avalon_sgdma_open("/dev/sgdma_m2s");
 	alt_sgdma_dev * sgdma_s2m = alt_avalon_sgdma_open("/dev/sgdma_s2m");
+#endif
 
 	// Values used by hwProcessImage - sgdma_m2s, sgdma_s2m - to signal end of job
 	volatile alt_u16 tx_done = 0;
 	volatile alt_u16 rx_done = 0;
 
 	alt_8 input_filename[INPUT_FILENAME_MAX_LEN];
+#if WRITE_OUTPUTS_TO_FILE>0
 	alt_8 output_filename[OUTPUT_FILENAME_MAX_LEN];
+#endif
+	alt_8 manifest_filename[BATCH_FILENAME_MAX_LEN];
 	ScalingFactor_t scaling_factor;
 	IncreaseDecreaseResolution_t increase_decrease;
 
 	ImagePartParameters_t image_part_parameters;
+	PointOperation_t point_operation;
 
 	Image_t input_image;
 	Image_t output_image;
+#if HOST_BUILD==0
+	alt_u32 sw_crc;
+	alt_u32 hw_crc;
+#endif
+
+	memset(&job_buffers, 0, sizeof(job_buffers));
+	if (createArena(&job_arena, JOB_ARENA_SIZE)) {
+		return 1;
+	}
+#if HOST_BUILD==0
+	// hw and sw speed measured by previous runs
+	loadHybridCalibration();
+#endif
+
+	// other acc_scale instances with their sgdmas (only instance 0 on host without model)
+	openAccScaleInstances(sgdma_m2s, &tx_done, sgdma_s2m, &rx_done);
+#if HW_PYRAMID>0
+	openPyramid();
+#endif
+
+#if HOST_BUILD==0
+	// acc_linear_function does no point operation until a job sets it (reset values are a=2, b=3)
+	point_operation.type = POINT_NONE;
+	hwSetPointOperation(&point_operation);
+#endif
 
     alt_32 choice;
     while(1) {
         printf("Another processing: {1}\n");
+        printf("Batch processing:   {2}\n");
+#if HOST_BUILD>0
+        printf("SW benchmark:       {3}\n");
+#endif
+#if TRAFFIC_TEST>0
+        printf("Traffic test:       {4}\n");
+#endif
         printf("Exit:               {0}\n");
         choice = getchar();
         while(getchar() != '\n');
@@ -947,6 +5752,7 @@ int main () {
         switch(choice) {
         case '1':
 
+#if HOST_BUILD==0
 			// Make sure SG-DMAs were opened correctly
 			if(sgdma_m2s == NULL)
 			{
@@ -958,6 +5764,10 @@ int main () {
 				printf("Could not open the receive SG-DMA\n");
 				break;
 			}
+#endif
+
+            // memory of previous run is given back at once
+            resetJobBuffers(&job_buffers);
 
             // ----------------------------------------------------------------
             // parse user inputted: input filename, scaling factor and increase/decrease
@@ -973,57 +5783,53 @@ int main () {
                 break;
             }
 
-            // ----------------------------------------------------------------
-            // read input image height, width and pixels from binary file
 			// ----------------------------------------------------------------
-            if (loadImage(input_filename, &input_image)) {
+            // parse user inputted: point operation done before scaling
+            // ----------------------------------------------------------------
+            if (pointOperationUserInput(&point_operation)) {
                 break;
             }
 
             // ----------------------------------------------------------------
-            // form input image based on part of image input instructions
+            // read input image height, width and pixels from binary file
 			// ----------------------------------------------------------------
-            if(formInputImage(image_part_parameters, &input_image)) {
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-                break;
+            if (isTiledImage(input_filename)) {
+                // tiled image: only tiles overlapping part of image are read
+                if (loadTiledImage(input_filename, image_part_parameters, &input_image, &job_buffers.input_image, &job_buffers.tiles)) {
+                    break;
+                }
+            } else {
+                if (loadImage(input_filename, &input_image, &job_buffers.input_image)) {
+                    break;
+                }
+
+                // ----------------------------------------------------------------
+                // form input image based on part of image input instructions
+                // ----------------------------------------------------------------
+                if(formInputImage(image_part_parameters, &input_image)) {
+                    break;
+                }
             }
 
             // ----------------------------------------------------------------
             // form output image buffer and parameters
 			// ----------------------------------------------------------------
-            if (formOutputImage(scaling_factor, increase_decrease, input_image, &output_image)) {
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
+            if (formOutputImage(scaling_factor, increase_decrease, input_image, &output_image, &job_buffers.output_image)) {
                 break;
             }
 
+#if HOST_BUILD==0
 			// ----------------------------------------------------------------
 			// Allocating descriptor table space from main memory.
 			// ----------------------------------------------------------------
 			if (createDescriptors(
 					&m2s_desc,
-                    &m2s_desc_copy,
+                    &job_buffers.m2s_descriptors,
 					&s2m_desc,
-                    &s2m_desc_copy,
+                    &job_buffers.s2m_descriptors,
                     input_image,
                     output_image)) {
 				printf("Allocating the descriptor memory failed...\n");
-				// free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-				for(alt_u32 i = 0; i < output_image.height; i++) {
-					free((output_image.pixels)[i]);
-				}
-				free(output_image.pixels);
                 break;
 			}
 
@@ -1048,6 +5854,7 @@ int main () {
 					 ALTERA_AVALON_SGDMA_CONTROL_IE_CHAIN_COMPLETED_MSK |
 					 ALTERA_AVALON_SGDMA_CONTROL_PARK_MSK),
 				   (void*)&tx_done);
+#endif
 
 			/*
 			 * Reset performance counter. Start global counter.
@@ -1061,31 +5868,19 @@ int main () {
 			 * Data processing with 2 different functions - software and hardware.
 			 * Performance is measured for each approach.
 			 */
-			alt_dcache_flush_all();
 
 			PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 1);
 
             // ----------------------------------------------------------------
             // SW process: input image ---> output image
 			// ----------------------------------------------------------------
-            if (swProcessImage(
+            if (swPointProcessImage(
+                    &point_operation,
                     scaling_factor,
                     increase_decrease,
                     input_image,
                     output_image)) {
 				printf("Scale function software processing failed...\n");
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-				for(alt_u32 i = 0; i < output_image.height; i++) {
-					free((output_image.pixels)[i]);
-				}
-				free(output_image.pixels);
-				// v2
-                free(m2s_desc_copy);
-                free(s2m_desc_copy);
                 break;
             }
 
@@ -1098,31 +5893,32 @@ int main () {
 			sprintf((char*)output_filename, "%s_%s%u.bin", OUTPUT_FILENAME_SW, ((increase_decrease == INCREASE) ? "inc" : "dec"), scaling_factor);
 			printf("Output filename software processing: %s\n", output_filename);
             if (storeImage(output_filename, output_image)) {
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-				for(alt_u32 i = 0; i < output_image.height; i++) {
-					free((output_image.pixels)[i]);
-				}
-				free(output_image.pixels);
-				// v2
-                free(m2s_desc_copy);
-                free(s2m_desc_copy);
                 break;
             }
 #endif
 
+#if HOST_BUILD==0
+            // ----------------------------------------------------------------
+            // crc32 of sw results, compared with crc32 computed by acc_scale
+			// ----------------------------------------------------------------
+            sw_crc = crc32Image(output_image);
+
             // ----------------------------------------------------------------
             // reset output image data to all 0
 			// ----------------------------------------------------------------
             for(alt_u32 i = 0; i < output_image.height; i++) {
             	for(alt_u32 j = 0; j < output_image.width; j++) {
-            		(output_image.pixels)[i][j] = 0;
+            		output_image.pixels[i * output_image.stride + j] = 0;
             	}
             }
-			
+
+            // input image and zeroed output image are written back to memory before transfer
+            dcacheFlushImage(input_image);
+            dcacheFlushImage(output_image);
+
+            // point operation in acc_linear_function (if chained in front of acc_scale)
+            hwSetPointOperation(&point_operation);
+
             PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 2);
 
             // ----------------------------------------------------------------
@@ -1137,25 +5933,38 @@ int main () {
 					&rx_done,
                     scaling_factor,
                     increase_decrease,
-                    input_image)) {
+                    input_image,
+                    output_image,
+                    0)) {
 				printf("Scale function hardware processing failed...\n");
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-				for(alt_u32 i = 0; i < output_image.height; i++) {
-					free((output_image.pixels)[i]);
-				}
-				free(output_image.pixels);
-				// v2
-                free(m2s_desc_copy);
-                free(s2m_desc_copy);
                 break;
             }
 
             PERF_END(PERFORMANCE_COUNTER_BASE, 2);
 
+            // ----------------------------------------------------------------
+			// validate hwProcessImage results
+            // ----------------------------------------------------------------
+            if (validateResultsHW(
+                    scaling_factor,
+                    increase_decrease,
+                    input_image,
+                    output_image)) {
+				printf("Validate Results HW function failed...\n");
+                break;
+            }
+
+#if FUSED_PIPELINE>0
+            hw_crc = readHwCrc(ACC_SCALE_BASE);
+#else
+            // point operation is not done by hw, second pass on NIOS that acc_scale crc does not cover
+            PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 2);
+            swPointOperationImage(&point_operation, output_image);
+            PERF_END(PERFORMANCE_COUNTER_BASE, 2);
+            hw_crc = (point_operation.type == POINT_NONE) ? readHwCrc(ACC_SCALE_BASE) : crc32Image(output_image);
+#endif
+            printf("CRC32 SW: %08x, HW: %08x %s\n", (unsigned int)sw_crc, (unsigned int)hw_crc, (sw_crc == hw_crc) ? "(match)" : "(MISMATCH)");
+
 #if WRITE_OUTPUTS_TO_FILE>0
             // ----------------------------------------------------------------
             // write output image height, width and pixels to binary file
@@ -1163,73 +5972,145 @@ int main () {
 			sprintf((char*)output_filename, "%s_%s%u.bin", OUTPUT_FILENAME_HW, ((increase_decrease == INCREASE) ? "inc" : "dec"), scaling_factor);
 		    printf("Output filename hardware processing: %s\n", output_filename);
             if (storeImage(output_filename, output_image)) {
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-				for(alt_u32 i = 0; i < output_image.height; i++) {
-					free((output_image.pixels)[i]);
-				}
-				free(output_image.pixels);
-				// v2
-                free(m2s_desc_copy);
-                free(s2m_desc_copy);
                 break;
             }
 #endif
 
+#if HYBRID_PROCESSING>0
             // ----------------------------------------------------------------
-			// validate hwProcessImage results
-            // ----------------------------------------------------------------
-            if (validateResultsHW(
+            // hybrid process: hw and sw speed of this image are calibration
+            // for the split, result has to be the same as sw result
+			// ----------------------------------------------------------------
+            if (recordHybridCalibration(
+                    scaling_factor,
+                    increase_decrease,
+                    (alt_u64)output_image.width * output_image.height,
+                    perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 2),
+                    perf_get_section_time((void*)PERFORMANCE_COUNTER_BASE, 1))) {
+                break;
+            }
+
+            for(alt_u32 i = 0; i < output_image.height; i++) {
+            	memset(output_image.pixels + i * output_image.stride, 0, output_image.width);
+            }
+
+            PERF_BEGIN(PERFORMANCE_COUNTER_BASE, 3);
+            if (hybridProcessImage(
+                    sgdma_m2s,
+                    &tx_done,
+                    sgdma_s2m,
+                    &rx_done,
+                    &job_buffers,
                     scaling_factor,
                     increase_decrease,
                     input_image,
-                    output_image)) {
-				printf("Validate Results HW function failed...\n");
-                // free dynamic memory
-				for(alt_u32 i = 0; i < input_image.height; i++) {
-					free((input_image.pixels)[i]);
-				}
-				free(input_image.pixels);
-				for(alt_u32 i = 0; i < output_image.height; i++) {
-					free((output_image.pixels)[i]);
-				}
-				free(output_image.pixels);
-				// v2
-                free(m2s_desc_copy);
-                free(s2m_desc_copy);
+                    output_image,
+                    0)) {
+				printf("Scale function hybrid processing failed...\n");
                 break;
             }
+#if FUSED_PIPELINE==0
+            swPointOperationImage(&point_operation, output_image);
+#endif
+            PERF_END(PERFORMANCE_COUNTER_BASE, 3);
+
+            hw_crc = crc32Image(output_image);
+            printf("CRC32 SW: %08x, hybrid: %08x %s\n", (unsigned int)sw_crc, (unsigned int)hw_crc, (sw_crc == hw_crc) ? "(match)" : "(MISMATCH)");
+#endif
 
             // ----------------------------------------------------------------
 			// printing formated report
             // ----------------------------------------------------------------
+#if HYBRID_PROCESSING>0
+            perf_print_formatted_report(PERFORMANCE_COUNTER_BASE,
+          		                            alt_get_cpu_freq(),
+          		                                             3,
+          		                          "sw_scale",
+          		                          "hw_scale",
+          		                          "hybrid_scale");
+#else
             perf_print_formatted_report(PERFORMANCE_COUNTER_BASE,
           		                            alt_get_cpu_freq(),
           		                                             2,
           		                          "sw_scale",
           		                          "hw_scale");
+#endif
+#else
+            perf_print_formatted_report(PERFORMANCE_COUNTER_BASE,
+          		                            alt_get_cpu_freq(),
+          		                                             1,
+          		                          "sw_scale");
+#endif
+            printIoReport();
 
-            // ----------------------------------------------------------------
-            // free dynamic memory
-			// ----------------------------------------------------------------
-			for(alt_u32 i = 0; i < input_image.height; i++) {
-				free((input_image.pixels)[i]);
+			printf("\nProcessing success!!!\n\n");
+            break;
+        case '2':
+
+#if HOST_BUILD==0
+			// Make sure SG-DMAs were opened correctly
+			if(sgdma_m2s == NULL)
+			{
+				printf("Could not open the transmit SG-DMA\n");
+				break;
 			}
-			free(input_image.pixels);
-			for(alt_u32 i = 0; i < output_image.height; i++) {
-				free((output_image.pixels)[i]);
+			if(sgdma_s2m == NULL)
+			{
+				printf("Could not open the receive SG-DMA\n");
+				break;
 			}
-			free(output_image.pixels);
-			// v2
-			free(m2s_desc_copy);
-			free(s2m_desc_copy);
+#endif
 
-			printf("\nProcessing success!!!\n\n");
+            // ----------------------------------------------------------------
+            // parse user inputted: manifest filename
+			// ----------------------------------------------------------------
+            printf("{manifest filename}\n");
+            if (fgets((char*)manifest_filename, BATCH_FILENAME_MAX_LEN, stdin) == NULL) {
+                break;
+            }
+            if (strchr((char*)manifest_filename, '\n') == NULL) {
+                printf("ERROR: Manifest filename exceeded maximum alowed lenght of %d characters\n", BATCH_FILENAME_MAX_LEN);
+                while(getchar() != '\n');
+                break;
+            }
+            manifest_filename[strcspn((char*)manifest_filename, " \r\n")] = '\0';
+
+            // ----------------------------------------------------------------
+            // run all the jobs from manifest
+			// ----------------------------------------------------------------
+            if (runBatch(manifest_filename, &job_buffers, sgdma_m2s, &tx_done, sgdma_s2m, &rx_done)) {
+                printf("\nBatch processing finished with errors!!!\n\n");
+                break;
+            }
+
+			printf("\nBatch processing success!!!\n\n");
+            break;
+#if HOST_BUILD>0
+        case '3':
+            if (runSwBenchmark(&job_buffers) || runSwTileBenchmark(&job_buffers)) {
+                printf("\nSW benchmark failed!!!\n\n");
+                break;
+            }
+
+			printf("\nSW benchmark success!!!\n\n");
+            break;
+#endif
+#if TRAFFIC_TEST>0
+        case '4':
+            if (runTrafficTest(&job_buffers)) {
+                printf("\nTraffic test finished with errors!!!\n\n");
+                break;
+            }
+
+			printf("\nTraffic test success!!!\n\n");
             break;
+#endif
         case '0':
+			resetJobBuffers(&job_buffers);
+			destroyArena(&job_arena);
+#if HOST_BUILD>0
+			swPoolStop();
+#endif
         	printf("\nWARNING: PROGRAM ENDED!\n");
             exit(0);
             break;
@@ -0,0 +1,356 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+-- Avalon-ST sink that checks and measures one frame of WIDTH x HEIGHT pixels per start. It is
+-- placed behind accelerator fed by stream_generator, so throughput of accelerator is measured
+-- without SGDMA and SDRAM limits. Backpressure is inserted by dropping ready, received pixels
+-- are compared with the same patterns stream_generator sends (compare bit, useful when
+-- accelerator passes pixels unchanged) and CRC32 of all received pixels can be compared with
+-- CRC32 of expected output computed by software (same CRC as acc_scale).
+--
+-- Registers (8 bit, byte addresses):
+--   0x00 - 0x03  WIDTH        pixels in one row (little endian)
+--   0x04 - 0x07  HEIGHT       rows in frame (little endian)
+--   0x08         STATUS       bit 0: busy (frame is being received), bit 1: error (ERRORS /= 0)
+--   0x09         CONTROL      bit 7: reset (autoreset), bit 6: start (autoreset),
+--                             bit 2: compare pixels with pattern, bits 1-0: pattern (00 ramp, 01 prbs, 10 constant)
+--   0x0A         VALUE        first pixel of ramp, seed of prbs (0 is used as 1), constant pixel
+--   0x0B         READY_PERIOD ready is dropped after every READY_PERIOD pixels (0: no backpressure)
+--   0x0C         READY_LENGTH clocks without ready in one drop
+--   0x10 - 0x13  CYCLES       clocks from the first to the last pixel received, both included (read only)
+--   0x14 - 0x17  ERRORS       pixels different from pattern (read only)
+--   0x18 - 0x1B  IDLE         clocks with ready and without valid after the first pixel, starving of sink (read only)
+--   0x1C - 0x1F  CRC          crc32 of received pixels (read only)
+
+entity stream_checker is
+	port (
+		reset                  : in  std_logic;                     -- reset
+		avs_params_address     : in  std_logic_vector(4 downto 0);  -- params.address
+		avs_params_read        : in  std_logic;                     -- .read
+		avs_params_readdata    : out std_logic_vector(7 downto 0);  -- .readdata
+		avs_params_write       : in  std_logic;                     -- .write
+		avs_params_writedata   : in  std_logic_vector(7 downto 0);  -- .writedata
+		avs_params_waitrequest : out std_logic;                     -- .waitrequest
+		clk                    : in  std_logic;                     -- clock
+		asi_in_data            : in  std_logic_vector(7 downto 0);  -- in.data
+		asi_in_ready           : out std_logic;                     -- .ready
+		asi_in_valid           : in  std_logic;                     -- .valid
+		asi_in_sop             : in  std_logic;                     -- .startofpacket
+		asi_in_eop             : in  std_logic                      -- .endofpacket
+	);
+end entity stream_checker;
+
+architecture rtl of stream_checker is
+		-- AVALON INTERFACE
+			-- address
+	constant C_ADDR_WIDTH_0      : std_logic_vector(4 downto 0) := "00000";
+	constant C_ADDR_WIDTH_1      : std_logic_vector(4 downto 0) := "00001";
+	constant C_ADDR_WIDTH_2      : std_logic_vector(4 downto 0) := "00010";
+	constant C_ADDR_WIDTH_3      : std_logic_vector(4 downto 0) := "00011";
+	constant C_ADDR_HEIGHT_0     : std_logic_vector(4 downto 0) := "00100";
+	constant C_ADDR_HEIGHT_1     : std_logic_vector(4 downto 0) := "00101";
+	constant C_ADDR_HEIGHT_2     : std_logic_vector(4 downto 0) := "00110";
+	constant C_ADDR_HEIGHT_3     : std_logic_vector(4 downto 0) := "00111";
+	constant C_ADDR_STATUS       : std_logic_vector(4 downto 0) := "01000";
+	constant C_ADDR_CONTROL      : std_logic_vector(4 downto 0) := "01001";
+	constant C_ADDR_VALUE        : std_logic_vector(4 downto 0) := "01010";
+	constant C_ADDR_READY_PERIOD : std_logic_vector(4 downto 0) := "01011";
+	constant C_ADDR_READY_LENGTH : std_logic_vector(4 downto 0) := "01100";
+	constant C_ADDR_CYCLES_0     : std_logic_vector(4 downto 0) := "10000";
+	constant C_ADDR_CYCLES_1     : std_logic_vector(4 downto 0) := "10001";
+	constant C_ADDR_CYCLES_2     : std_logic_vector(4 downto 0) := "10010";
+	constant C_ADDR_CYCLES_3     : std_logic_vector(4 downto 0) := "10011";
+	constant C_ADDR_ERRORS_0     : std_logic_vector(4 downto 0) := "10100";
+	constant C_ADDR_ERRORS_1     : std_logic_vector(4 downto 0) := "10101";
+	constant C_ADDR_ERRORS_2     : std_logic_vector(4 downto 0) := "10110";
+	constant C_ADDR_ERRORS_3     : std_logic_vector(4 downto 0) := "10111";
+	constant C_ADDR_IDLE_0       : std_logic_vector(4 downto 0) := "11000";
+	constant C_ADDR_IDLE_1       : std_logic_vector(4 downto 0) := "11001";
+	constant C_ADDR_IDLE_2       : std_logic_vector(4 downto 0) := "11010";
+	constant C_ADDR_IDLE_3       : std_logic_vector(4 downto 0) := "11011";
+	constant C_ADDR_CRC_0        : std_logic_vector(4 downto 0) := "11100";
+	constant C_ADDR_CRC_1        : std_logic_vector(4 downto 0) := "11101";
+	constant C_ADDR_CRC_2        : std_logic_vector(4 downto 0) := "11110";
+	constant C_ADDR_CRC_3        : std_logic_vector(4 downto 0) := "11111";
+
+			-- pattern
+	constant C_PATTERN_RAMP      : std_logic_vector(1 downto 0) := "00";
+	constant C_PATTERN_PRBS      : std_logic_vector(1 downto 0) := "01";
+
+			-- params registers
+	signal reg_width          : std_logic_vector(31 downto 0);
+	signal reg_height         : std_logic_vector(31 downto 0);
+	signal reg_control        : std_logic_vector(7 downto 0);
+	signal reg_value          : std_logic_vector(7 downto 0);
+	signal reg_ready_period   : unsigned(7 downto 0);
+	signal reg_ready_length   : unsigned(7 downto 0);
+	signal status             : std_logic_vector(7 downto 0);
+	signal read_out_mux       : std_logic_vector(7 downto 0);
+
+	signal strobe_control     : std_logic;
+	signal bit_reset          : std_logic;
+	signal bit_start          : std_logic;
+	signal bit_compare        : std_logic;
+	signal pattern            : std_logic_vector(1 downto 0);
+	signal int_reset          : std_logic;
+
+		-- CHECKER
+	type State_t is (st_idle, st_receive, st_hold);
+	signal reg_current_state : State_t;
+
+	signal column             : unsigned(31 downto 0);	-- pixels left in row - 1
+	signal rows_left          : unsigned(31 downto 0);	-- rows left in frame - 1
+	signal ready_beats        : unsigned(7 downto 0);	-- pixels received since ready was dropped
+	signal hold_left          : unsigned(7 downto 0);	-- clocks left without ready
+	signal expected           : std_logic_vector(7 downto 0);
+	signal started            : std_logic;				-- first pixel was received
+	signal last_pixel         : std_logic;
+	signal transfer           : std_logic;
+
+	signal reg_cycles         : unsigned(31 downto 0);
+	signal reg_errors         : unsigned(31 downto 0);
+	signal reg_idle           : unsigned(31 downto 0);
+	signal reg_crc            : std_logic_vector(31 downto 0);
+	signal crc                : std_logic_vector(31 downto 0);
+
+	signal int_asi_in_ready   : std_logic;
+
+	-- first pixel of frame for given pattern
+	function pattern_first(pattern : std_logic_vector(1 downto 0); value : std_logic_vector(7 downto 0)) return std_logic_vector is
+	begin
+		if ((pattern = C_PATTERN_PRBS) and (value = x"00")) then
+			return x"01";	-- all zero state would lock LFSR
+		end if;
+		return value;
+	end function pattern_first;
+
+	-- pixel that follows given pixel of pattern
+	function pattern_next(pattern : std_logic_vector(1 downto 0); value : std_logic_vector(7 downto 0)) return std_logic_vector is
+	begin
+		if (pattern = C_PATTERN_RAMP) then
+			return std_logic_vector(unsigned(value) + 1);
+		elsif (pattern = C_PATTERN_PRBS) then
+			return value(6 downto 0) & (value(7) xor value(5) xor value(4) xor value(3));
+		end if;
+		return value;
+	end function pattern_next;
+
+	-- crc32 (IEEE 802.3, reflected) of one byte, same as zlib crc32 without final inversion
+	function crc32_update(crc_in : std_logic_vector(31 downto 0); data : std_logic_vector(7 downto 0)) return std_logic_vector is
+		variable c : std_logic_vector(31 downto 0);
+	begin
+		c := crc_in;
+		for i in 0 to 7 loop
+			if ((c(0) xor data(i)) = '1') then
+				c := ('0' & c(31 downto 1)) xor x"EDB88320";
+			else
+				c := '0' & c(31 downto 1);
+			end if;
+		end loop;
+		return c;
+	end function crc32_update;
+begin
+---------------------------------------------------------------------------
+-- AVALON INTERFACE
+---------------------------------------------------------------------------
+	strobe_control <= '1' when (avs_params_write = '1') and (avs_params_address = C_ADDR_CONTROL) else '0';
+
+	-- params registers
+	PROC_REG_PARAMS: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_width <= (others => '0');
+			reg_height <= (others => '0');
+			reg_value <= (others => '0');
+			reg_ready_period <= (others => '0');
+			reg_ready_length <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (avs_params_write = '1') then
+				case avs_params_address is
+					when C_ADDR_WIDTH_0      => reg_width(7 downto 0) <= avs_params_writedata;
+					when C_ADDR_WIDTH_1      => reg_width(15 downto 8) <= avs_params_writedata;
+					when C_ADDR_WIDTH_2      => reg_width(23 downto 16) <= avs_params_writedata;
+					when C_ADDR_WIDTH_3      => reg_width(31 downto 24) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_0     => reg_height(7 downto 0) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_1     => reg_height(15 downto 8) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_2     => reg_height(23 downto 16) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_3     => reg_height(31 downto 24) <= avs_params_writedata;
+					when C_ADDR_VALUE        => reg_value <= avs_params_writedata;
+					when C_ADDR_READY_PERIOD => reg_ready_period <= unsigned(avs_params_writedata);
+					when C_ADDR_READY_LENGTH => reg_ready_length <= unsigned(avs_params_writedata);
+					when others => null;
+				end case;
+			end if;
+		end if;
+	end process PROC_REG_PARAMS;
+
+	-- reg control, reset and start bits are autoreset
+	PROC_REG_CONTROL: process (clk, reset) is
+	begin
+		if (reset = '1') then
+			reg_control <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (strobe_control = '1') then
+				reg_control <= avs_params_writedata;
+			else
+				reg_control(7 downto 6) <= "00";
+			end if;
+		end if;
+	end process PROC_REG_CONTROL;
+
+	bit_reset <= reg_control(7);
+	bit_start <= reg_control(6);
+	bit_compare <= reg_control(2);
+	pattern <= reg_control(1 downto 0);
+
+	-- internal reset that allowes software reset by writing to control register
+	int_reset <= reset or bit_reset;
+
+	-- status
+	status(7 downto 2) <= (others => '0');
+	status(1) <= '0' when (reg_errors = 0) else '1';
+	status(0) <= '0' when (reg_current_state = st_idle) else '1';
+
+	-- read_out_mux
+	read_out_mux <= reg_width(7 downto 0)     when (avs_params_address = C_ADDR_WIDTH_0)    else
+					reg_width(15 downto 8)    when (avs_params_address = C_ADDR_WIDTH_1)    else
+					reg_width(23 downto 16)   when (avs_params_address = C_ADDR_WIDTH_2)    else
+					reg_width(31 downto 24)   when (avs_params_address = C_ADDR_WIDTH_3)    else
+					reg_height(7 downto 0)    when (avs_params_address = C_ADDR_HEIGHT_0)   else
+					reg_height(15 downto 8)   when (avs_params_address = C_ADDR_HEIGHT_1)   else
+					reg_height(23 downto 16)  when (avs_params_address = C_ADDR_HEIGHT_2)   else
+					reg_height(31 downto 24)  when (avs_params_address = C_ADDR_HEIGHT_3)   else
+					status                    when (avs_params_address = C_ADDR_STATUS)     else
+					reg_control               when (avs_params_address = C_ADDR_CONTROL)    else
+					reg_value                 when (avs_params_address = C_ADDR_VALUE)      else
+					std_logic_vector(reg_ready_period) when (avs_params_address = C_ADDR_READY_PERIOD) else
+					std_logic_vector(reg_ready_length) when (avs_params_address = C_ADDR_READY_LENGTH) else
+					std_logic_vector(reg_cycles(7 downto 0))   when (avs_params_address = C_ADDR_CYCLES_0) else
+					std_logic_vector(reg_cycles(15 downto 8))  when (avs_params_address = C_ADDR_CYCLES_1) else
+					std_logic_vector(reg_cycles(23 downto 16)) when (avs_params_address = C_ADDR_CYCLES_2) else
+					std_logic_vector(reg_cycles(31 downto 24)) when (avs_params_address = C_ADDR_CYCLES_3) else
+					std_logic_vector(reg_errors(7 downto 0))   when (avs_params_address = C_ADDR_ERRORS_0) else
+					std_logic_vector(reg_errors(15 downto 8))  when (avs_params_address = C_ADDR_ERRORS_1) else
+					std_logic_vector(reg_errors(23 downto 16)) when (avs_params_address = C_ADDR_ERRORS_2) else
+					std_logic_vector(reg_errors(31 downto 24)) when (avs_params_address = C_ADDR_ERRORS_3) else
+					std_logic_vector(reg_idle(7 downto 0))     when (avs_params_address = C_ADDR_IDLE_0)   else
+					std_logic_vector(reg_idle(15 downto 8))    when (avs_params_address = C_ADDR_IDLE_1)   else
+					std_logic_vector(reg_idle(23 downto 16))   when (avs_params_address = C_ADDR_IDLE_2)   else
+					std_logic_vector(reg_idle(31 downto 24))   when (avs_params_address = C_ADDR_IDLE_3)   else
+					crc(7 downto 0)           when (avs_params_address = C_ADDR_CRC_0)      else
+					crc(15 downto 8)          when (avs_params_address = C_ADDR_CRC_1)      else
+					crc(23 downto 16)         when (avs_params_address = C_ADDR_CRC_2)      else
+					crc(31 downto 24)         when (avs_params_address = C_ADDR_CRC_3)      else
+					x"00";
+
+	-- reg readdata
+	PROC_REG_READDATA: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			avs_params_readdata <= (others => '0');
+		elsif (rising_edge(clk)) then
+			avs_params_readdata <= read_out_mux;
+		end if;
+	end process PROC_REG_READDATA;
+
+	-- avs_params_read is unused
+	avs_params_waitrequest <= '0';
+
+---------------------------------------------------------------------------
+-- CHECKER
+---------------------------------------------------------------------------
+	int_asi_in_ready <= '1' when (reg_current_state = st_receive) else '0';
+	transfer <= int_asi_in_ready and asi_in_valid;
+	last_pixel <= '1' when ((column = 0) and (rows_left = 0)) else '0';
+
+	PROC_CHECKER: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_current_state <= st_idle;
+			column <= (others => '0');
+			rows_left <= (others => '0');
+			ready_beats <= (others => '0');
+			hold_left <= (others => '0');
+			expected <= (others => '0');
+		elsif (rising_edge(clk)) then
+			case reg_current_state is
+				when st_idle =>
+					if ((bit_start = '1') and (unsigned(reg_width) /= 0) and (unsigned(reg_height) /= 0)) then
+						reg_current_state <= st_receive;
+						column <= unsigned(reg_width) - 1;
+						rows_left <= unsigned(reg_height) - 1;
+						ready_beats <= (others => '0');
+						expected <= pattern_first(pattern, reg_value);
+					end if;
+
+				when st_receive =>
+					if (transfer = '1') then
+						expected <= pattern_next(pattern, expected);
+						if (column = 0) then
+							column <= unsigned(reg_width) - 1;
+							rows_left <= rows_left - 1;
+						else
+							column <= column - 1;
+						end if;
+
+						if (last_pixel = '1') then
+							reg_current_state <= st_idle;
+						elsif ((reg_ready_period /= 0) and (reg_ready_length /= 0) and (ready_beats = reg_ready_period - 1)) then
+							reg_current_state <= st_hold;
+							ready_beats <= (others => '0');
+							hold_left <= reg_ready_length - 1;
+						else
+							ready_beats <= ready_beats + 1;
+						end if;
+					end if;
+
+				when st_hold =>
+					if (hold_left = 0) then
+						reg_current_state <= st_receive;
+					else
+						hold_left <= hold_left - 1;
+					end if;
+			end case;
+		end if;
+	end process PROC_CHECKER;
+
+	-- counters and crc, cleared on start and kept after frame is received until the next start
+	PROC_COUNTERS: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			started <= '0';
+			reg_cycles <= (others => '0');
+			reg_errors <= (others => '0');
+			reg_idle <= (others => '0');
+			reg_crc <= (others => '1');
+		elsif (rising_edge(clk)) then
+			if ((reg_current_state = st_idle) and (bit_start = '1')) then
+				started <= '0';
+				reg_cycles <= (others => '0');
+				reg_errors <= (others => '0');
+				reg_idle <= (others => '0');
+				reg_crc <= (others => '1');
+			elsif (reg_current_state /= st_idle) then
+				if ((started = '1') or (transfer = '1')) then
+					reg_cycles <= reg_cycles + 1;
+				end if;
+				if (transfer = '1') then
+					started <= '1';
+					reg_crc <= crc32_update(reg_crc, asi_in_data);
+					if ((bit_compare = '1') and (asi_in_data /= expected)) then
+						reg_errors <= reg_errors + 1;
+					end if;
+				elsif ((started = '1') and (int_asi_in_ready = '1')) then
+					reg_idle <= reg_idle + 1;
+				end if;
+			end if;
+		end if;
+	end process PROC_COUNTERS;
+
+	crc <= not reg_crc;
+
+	-- asi_in_sop and asi_in_eop are unused (acc_scale does not drive them)
+	asi_in_ready <= int_asi_in_ready;
+
+end architecture rtl;
@@ -0,0 +1,307 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+-- Avalon-ST pattern generator used for throughput tests of accelerators (extends source_stimulus
+-- from simulation project). It sends one frame of WIDTH x HEIGHT pixels per start, so it can be
+-- placed in front of acc_scale instead of SGDMA and accelerator is measured without SGDMA and SDRAM
+-- limits. stream_checker is the matching sink.
+--
+-- Registers (8 bit, byte addresses):
+--   0x00 - 0x03  WIDTH       pixels in one row (little endian)
+--   0x04 - 0x07  HEIGHT      rows in frame (little endian)
+--   0x08         STATUS      bit 0: busy (frame is being sent)
+--   0x09         CONTROL     bit 7: reset (autoreset), bit 6: start (autoreset),
+--                            bits 1-0: pattern (00 ramp, 01 prbs, 10 constant)
+--   0x0A         VALUE       first pixel of ramp, seed of prbs (0 is used as 1), constant pixel
+--   0x0B         GAP_PERIOD  valid is dropped after every GAP_PERIOD pixels (0: no gaps)
+--   0x0C         GAP_LENGTH  clocks without valid in one gap
+--   0x10 - 0x13  CYCLES      clocks from start to the last pixel sent (read only)
+--   0x14 - 0x17  STALLS      clocks with valid and without ready, backpressure of sink (read only)
+--
+-- Ramp is incremented for every pixel, prbs is 8 bit LFSR x^8 + x^6 + x^5 + x^4 + 1 shifted for
+-- every pixel. Start of packet is set on the first pixel and end of packet on the last pixel.
+
+entity stream_generator is
+	port (
+		reset                  : in  std_logic;                     -- reset
+		avs_params_address     : in  std_logic_vector(4 downto 0);  -- params.address
+		avs_params_read        : in  std_logic;                     -- .read
+		avs_params_readdata    : out std_logic_vector(7 downto 0);  -- .readdata
+		avs_params_write       : in  std_logic;                     -- .write
+		avs_params_writedata   : in  std_logic_vector(7 downto 0);  -- .writedata
+		avs_params_waitrequest : out std_logic;                     -- .waitrequest
+		clk                    : in  std_logic;                     -- clock
+		aso_out_data           : out std_logic_vector(7 downto 0);  -- out.data
+		aso_out_ready          : in  std_logic;                     -- .ready
+		aso_out_valid          : out std_logic;                     -- .valid
+		aso_out_sop            : out std_logic;                     -- .startofpacket
+		aso_out_eop            : out std_logic                      -- .endofpacket
+	);
+end entity stream_generator;
+
+architecture rtl of stream_generator is
+		-- AVALON INTERFACE
+			-- address
+	constant C_ADDR_WIDTH_0    : std_logic_vector(4 downto 0) := "00000";
+	constant C_ADDR_WIDTH_1    : std_logic_vector(4 downto 0) := "00001";
+	constant C_ADDR_WIDTH_2    : std_logic_vector(4 downto 0) := "00010";
+	constant C_ADDR_WIDTH_3    : std_logic_vector(4 downto 0) := "00011";
+	constant C_ADDR_HEIGHT_0   : std_logic_vector(4 downto 0) := "00100";
+	constant C_ADDR_HEIGHT_1   : std_logic_vector(4 downto 0) := "00101";
+	constant C_ADDR_HEIGHT_2   : std_logic_vector(4 downto 0) := "00110";
+	constant C_ADDR_HEIGHT_3   : std_logic_vector(4 downto 0) := "00111";
+	constant C_ADDR_STATUS     : std_logic_vector(4 downto 0) := "01000";
+	constant C_ADDR_CONTROL    : std_logic_vector(4 downto 0) := "01001";
+	constant C_ADDR_VALUE      : std_logic_vector(4 downto 0) := "01010";
+	constant C_ADDR_GAP_PERIOD : std_logic_vector(4 downto 0) := "01011";
+	constant C_ADDR_GAP_LENGTH : std_logic_vector(4 downto 0) := "01100";
+	constant C_ADDR_CYCLES_0   : std_logic_vector(4 downto 0) := "10000";
+	constant C_ADDR_CYCLES_1   : std_logic_vector(4 downto 0) := "10001";
+	constant C_ADDR_CYCLES_2   : std_logic_vector(4 downto 0) := "10010";
+	constant C_ADDR_CYCLES_3   : std_logic_vector(4 downto 0) := "10011";
+	constant C_ADDR_STALLS_0   : std_logic_vector(4 downto 0) := "10100";
+	constant C_ADDR_STALLS_1   : std_logic_vector(4 downto 0) := "10101";
+	constant C_ADDR_STALLS_2   : std_logic_vector(4 downto 0) := "10110";
+	constant C_ADDR_STALLS_3   : std_logic_vector(4 downto 0) := "10111";
+
+			-- pattern
+	constant C_PATTERN_RAMP     : std_logic_vector(1 downto 0) := "00";
+	constant C_PATTERN_PRBS     : std_logic_vector(1 downto 0) := "01";
+
+			-- params registers
+	signal reg_width        : std_logic_vector(31 downto 0);
+	signal reg_height       : std_logic_vector(31 downto 0);
+	signal reg_control      : std_logic_vector(7 downto 0);
+	signal reg_value        : std_logic_vector(7 downto 0);
+	signal reg_gap_period   : unsigned(7 downto 0);
+	signal reg_gap_length   : unsigned(7 downto 0);
+	signal status           : std_logic_vector(7 downto 0);
+	signal read_out_mux     : std_logic_vector(7 downto 0);
+
+	signal strobe_control   : std_logic;
+	signal bit_reset        : std_logic;
+	signal bit_start        : std_logic;
+	signal pattern          : std_logic_vector(1 downto 0);
+	signal int_reset        : std_logic;
+
+		-- GENERATOR
+	type State_t is (st_idle, st_send, st_gap);
+	signal reg_current_state : State_t;
+
+	signal column           : unsigned(31 downto 0);	-- pixels left in row - 1
+	signal rows_left        : unsigned(31 downto 0);	-- rows left in frame - 1
+	signal gap_beats        : unsigned(7 downto 0);		-- pixels sent since the last gap
+	signal gap_left         : unsigned(7 downto 0);		-- clocks left in gap
+	signal sample           : std_logic_vector(7 downto 0);
+	signal first_pixel      : std_logic;
+	signal last_pixel       : std_logic;
+	signal transfer         : std_logic;
+
+	signal reg_cycles       : unsigned(31 downto 0);
+	signal reg_stalls       : unsigned(31 downto 0);
+
+	signal int_aso_out_valid : std_logic;
+
+	-- first pixel of frame for given pattern
+	function pattern_first(pattern : std_logic_vector(1 downto 0); value : std_logic_vector(7 downto 0)) return std_logic_vector is
+	begin
+		if ((pattern = C_PATTERN_PRBS) and (value = x"00")) then
+			return x"01";	-- all zero state would lock LFSR
+		end if;
+		return value;
+	end function pattern_first;
+
+	-- pixel that follows given pixel of pattern
+	function pattern_next(pattern : std_logic_vector(1 downto 0); value : std_logic_vector(7 downto 0)) return std_logic_vector is
+	begin
+		if (pattern = C_PATTERN_RAMP) then
+			return std_logic_vector(unsigned(value) + 1);
+		elsif (pattern = C_PATTERN_PRBS) then
+			return value(6 downto 0) & (value(7) xor value(5) xor value(4) xor value(3));
+		end if;
+		return value;
+	end function pattern_next;
+begin
+---------------------------------------------------------------------------
+-- AVALON INTERFACE
+---------------------------------------------------------------------------
+	strobe_control <= '1' when (avs_params_write = '1') and (avs_params_address = C_ADDR_CONTROL) else '0';
+
+	-- params registers
+	PROC_REG_PARAMS: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_width <= (others => '0');
+			reg_height <= (others => '0');
+			reg_value <= (others => '0');
+			reg_gap_period <= (others => '0');
+			reg_gap_length <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (avs_params_write = '1') then
+				case avs_params_address is
+					when C_ADDR_WIDTH_0    => reg_width(7 downto 0) <= avs_params_writedata;
+					when C_ADDR_WIDTH_1    => reg_width(15 downto 8) <= avs_params_writedata;
+					when C_ADDR_WIDTH_2    => reg_width(23 downto 16) <= avs_params_writedata;
+					when C_ADDR_WIDTH_3    => reg_width(31 downto 24) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_0   => reg_height(7 downto 0) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_1   => reg_height(15 downto 8) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_2   => reg_height(23 downto 16) <= avs_params_writedata;
+					when C_ADDR_HEIGHT_3   => reg_height(31 downto 24) <= avs_params_writedata;
+					when C_ADDR_VALUE      => reg_value <= avs_params_writedata;
+					when C_ADDR_GAP_PERIOD => reg_gap_period <= unsigned(avs_params_writedata);
+					when C_ADDR_GAP_LENGTH => reg_gap_length <= unsigned(avs_params_writedata);
+					when others => null;
+				end case;
+			end if;
+		end if;
+	end process PROC_REG_PARAMS;
+
+	-- reg control, reset and start bits are autoreset
+	PROC_REG_CONTROL: process (clk, reset) is
+	begin
+		if (reset = '1') then
+			reg_control <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if (strobe_control = '1') then
+				reg_control <= avs_params_writedata;
+			else
+				reg_control(7 downto 6) <= "00";
+			end if;
+		end if;
+	end process PROC_REG_CONTROL;
+
+	bit_reset <= reg_control(7);
+	bit_start <= reg_control(6);
+	pattern <= reg_control(1 downto 0);
+
+	-- internal reset that allowes software reset by writing to control register
+	int_reset <= reset or bit_reset;
+
+	-- status
+	status(7 downto 1) <= (others => '0');
+	status(0) <= '0' when (reg_current_state = st_idle) else '1';
+
+	-- read_out_mux
+	read_out_mux <= reg_width(7 downto 0)     when (avs_params_address = C_ADDR_WIDTH_0)    else
+					reg_width(15 downto 8)    when (avs_params_address = C_ADDR_WIDTH_1)    else
+					reg_width(23 downto 16)   when (avs_params_address = C_ADDR_WIDTH_2)    else
+					reg_width(31 downto 24)   when (avs_params_address = C_ADDR_WIDTH_3)    else
+					reg_height(7 downto 0)    when (avs_params_address = C_ADDR_HEIGHT_0)   else
+					reg_height(15 downto 8)   when (avs_params_address = C_ADDR_HEIGHT_1)   else
+					reg_height(23 downto 16)  when (avs_params_address = C_ADDR_HEIGHT_2)   else
+					reg_height(31 downto 24)  when (avs_params_address = C_ADDR_HEIGHT_3)   else
+					status                    when (avs_params_address = C_ADDR_STATUS)     else
+					reg_control               when (avs_params_address = C_ADDR_CONTROL)    else
+					reg_value                 when (avs_params_address = C_ADDR_VALUE)      else
+					std_logic_vector(reg_gap_period) when (avs_params_address = C_ADDR_GAP_PERIOD) else
+					std_logic_vector(reg_gap_length) when (avs_params_address = C_ADDR_GAP_LENGTH) else
+					std_logic_vector(reg_cycles(7 downto 0))   when (avs_params_address = C_ADDR_CYCLES_0) else
+					std_logic_vector(reg_cycles(15 downto 8))  when (avs_params_address = C_ADDR_CYCLES_1) else
+					std_logic_vector(reg_cycles(23 downto 16)) when (avs_params_address = C_ADDR_CYCLES_2) else
+					std_logic_vector(reg_cycles(31 downto 24)) when (avs_params_address = C_ADDR_CYCLES_3) else
+					std_logic_vector(reg_stalls(7 downto 0))   when (avs_params_address = C_ADDR_STALLS_0) else
+					std_logic_vector(reg_stalls(15 downto 8))  when (avs_params_address = C_ADDR_STALLS_1) else
+					std_logic_vector(reg_stalls(23 downto 16)) when (avs_params_address = C_ADDR_STALLS_2) else
+					std_logic_vector(reg_stalls(31 downto 24)) when (avs_params_address = C_ADDR_STALLS_3) else
+					x"00";
+
+	-- reg readdata
+	PROC_REG_READDATA: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			avs_params_readdata <= (others => '0');
+		elsif (rising_edge(clk)) then
+			avs_params_readdata <= read_out_mux;
+		end if;
+	end process PROC_REG_READDATA;
+
+	-- avs_params_read is unused
+	avs_params_waitrequest <= '0';
+
+---------------------------------------------------------------------------
+-- GENERATOR
+---------------------------------------------------------------------------
+	int_aso_out_valid <= '1' when (reg_current_state = st_send) else '0';
+	transfer <= int_aso_out_valid and aso_out_ready;
+	last_pixel <= '1' when ((column = 0) and (rows_left = 0)) else '0';
+
+	PROC_GENERATOR: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_current_state <= st_idle;
+			column <= (others => '0');
+			rows_left <= (others => '0');
+			gap_beats <= (others => '0');
+			gap_left <= (others => '0');
+			sample <= (others => '0');
+			first_pixel <= '0';
+		elsif (rising_edge(clk)) then
+			case reg_current_state is
+				when st_idle =>
+					if ((bit_start = '1') and (unsigned(reg_width) /= 0) and (unsigned(reg_height) /= 0)) then
+						reg_current_state <= st_send;
+						column <= unsigned(reg_width) - 1;
+						rows_left <= unsigned(reg_height) - 1;
+						gap_beats <= (others => '0');
+						sample <= pattern_first(pattern, reg_value);
+						first_pixel <= '1';
+					end if;
+
+				when st_send =>
+					if (transfer = '1') then
+						sample <= pattern_next(pattern, sample);
+						first_pixel <= '0';
+						if (column = 0) then
+							column <= unsigned(reg_width) - 1;
+							rows_left <= rows_left - 1;
+						else
+							column <= column - 1;
+						end if;
+
+						if (last_pixel = '1') then
+							reg_current_state <= st_idle;
+						elsif ((reg_gap_period /= 0) and (reg_gap_length /= 0) and (gap_beats = reg_gap_period - 1)) then
+							reg_current_state <= st_gap;
+							gap_beats <= (others => '0');
+							gap_left <= reg_gap_length - 1;
+						else
+							gap_beats <= gap_beats + 1;
+						end if;
+					end if;
+
+				when st_gap =>
+					if (gap_left = 0) then
+						reg_current_state <= st_send;
+					else
+						gap_left <= gap_left - 1;
+					end if;
+			end case;
+		end if;
+	end process PROC_GENERATOR;
+
+	-- cycle and stall counters, cleared on start and kept after frame is sent
+	PROC_COUNTERS: process (clk, int_reset) is
+	begin
+		if (int_reset = '1') then
+			reg_cycles <= (others => '0');
+			reg_stalls <= (others => '0');
+		elsif (rising_edge(clk)) then
+			if ((reg_current_state = st_idle) and (bit_start = '1')) then
+				reg_cycles <= (others => '0');
+				reg_stalls <= (others => '0');
+			elsif (reg_current_state /= st_idle) then
+				reg_cycles <= reg_cycles + 1;
+				if ((int_aso_out_valid = '1') and (aso_out_ready = '0')) then
+					reg_stalls <= reg_stalls + 1;
+				end if;
+			end if;
+		end if;
+	end process PROC_COUNTERS;
+
+	aso_out_valid <= int_aso_out_valid;
+	aso_out_data <= sample;
+	aso_out_sop <= first_pixel;
+	aso_out_eop <= last_pixel;
+
+end architecture rtl;
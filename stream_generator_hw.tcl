@@ -0,0 +1,146 @@
+# TCL File Generated by Component Editor 18.1
+# Thu Jan 11 13:31:00 CET 2024
+# DO NOT MODIFY
+
+
+# 
+# stream_generator "stream_generator" v1.0
+# DT 2024.01.11.13:31:00
+# 
+# 
+
+# 
+# request TCL package from ACDS 16.1
+# 
+package require -exact qsys 16.1
+
+
+# 
+# module stream_generator
+# 
+set_module_property DESCRIPTION "Avalon-ST pattern generator for throughput tests"
+set_module_property NAME stream_generator
+set_module_property VERSION 1.0
+set_module_property INTERNAL false
+set_module_property OPAQUE_ADDRESS_MAP true
+set_module_property GROUP Accelerators
+set_module_property AUTHOR DT
+set_module_property DISPLAY_NAME stream_generator
+set_module_property INSTANTIATE_IN_SYSTEM_MODULE true
+set_module_property EDITABLE true
+set_module_property REPORT_TO_TALKBACK false
+set_module_property ALLOW_GREYBOX_GENERATION false
+set_module_property REPORT_HIERARCHY false
+
+
+# 
+# file sets
+# 
+add_fileset QUARTUS_SYNTH QUARTUS_SYNTH "" ""
+set_fileset_property QUARTUS_SYNTH TOP_LEVEL stream_generator
+set_fileset_property QUARTUS_SYNTH ENABLE_RELATIVE_INCLUDE_PATHS false
+set_fileset_property QUARTUS_SYNTH ENABLE_FILE_OVERWRITE_MODE false
+add_fileset_file stream_generator.vhd VHDL PATH stream_generator.vhd TOP_LEVEL_FILE
+
+
+# 
+# parameters
+# 
+
+
+# 
+# display items
+# 
+
+
+# 
+# connection point clock
+# 
+add_interface clock clock end
+set_interface_property clock clockRate 0
+set_interface_property clock ENABLED true
+set_interface_property clock EXPORT_OF ""
+set_interface_property clock PORT_NAME_MAP ""
+set_interface_property clock CMSIS_SVD_VARIABLES ""
+set_interface_property clock SVD_ADDRESS_GROUP ""
+
+add_interface_port clock clk clk Input 1
+
+
+# 
+# connection point reset
+# 
+add_interface reset reset end
+set_interface_property reset associatedClock clock
+set_interface_property reset synchronousEdges DEASSERT
+set_interface_property reset ENABLED true
+set_interface_property reset EXPORT_OF ""
+set_interface_property reset PORT_NAME_MAP ""
+set_interface_property reset CMSIS_SVD_VARIABLES ""
+set_interface_property reset SVD_ADDRESS_GROUP ""
+
+add_interface_port reset reset reset Input 1
+
+
+# 
+# connection point avs_params
+# 
+add_interface avs_params avalon end
+set_interface_property avs_params addressUnits SYMBOLS
+set_interface_property avs_params associatedClock clock
+set_interface_property avs_params associatedReset reset
+set_interface_property avs_params bitsPerSymbol 8
+set_interface_property avs_params bridgedAddressOffset 0
+set_interface_property avs_params burstOnBurstBoundariesOnly false
+set_interface_property avs_params burstcountUnits WORDS
+set_interface_property avs_params explicitAddressSpan 0
+set_interface_property avs_params holdTime 0
+set_interface_property avs_params linewrapBursts false
+set_interface_property avs_params maximumPendingReadTransactions 0
+set_interface_property avs_params maximumPendingWriteTransactions 0
+set_interface_property avs_params readLatency 0
+set_interface_property avs_params readWaitTime 1
+set_interface_property avs_params setupTime 0
+set_interface_property avs_params timingUnits Cycles
+set_interface_property avs_params writeWaitTime 0
+set_interface_property avs_params ENABLED true
+set_interface_property avs_params EXPORT_OF ""
+set_interface_property avs_params PORT_NAME_MAP ""
+set_interface_property avs_params CMSIS_SVD_VARIABLES ""
+set_interface_property avs_params SVD_ADDRESS_GROUP ""
+
+add_interface_port avs_params avs_params_address address Input 5
+add_interface_port avs_params avs_params_read read Input 1
+add_interface_port avs_params avs_params_readdata readdata Output 8
+add_interface_port avs_params avs_params_write write Input 1
+add_interface_port avs_params avs_params_writedata writedata Input 8
+add_interface_port avs_params avs_params_waitrequest waitrequest Output 1
+set_interface_assignment avs_params embeddedsw.configuration.isFlash 0
+set_interface_assignment avs_params embeddedsw.configuration.isMemoryDevice 0
+set_interface_assignment avs_params embeddedsw.configuration.isNonVolatileStorage 0
+set_interface_assignment avs_params embeddedsw.configuration.isPrintableDevice 0
+
+
+# 
+# connection point aso_out
+# 
+add_interface aso_out avalon_streaming start
+set_interface_property aso_out associatedClock clock
+set_interface_property aso_out associatedReset reset
+set_interface_property aso_out dataBitsPerSymbol 8
+set_interface_property aso_out errorDescriptor ""
+set_interface_property aso_out firstSymbolInHighOrderBits true
+set_interface_property aso_out maxChannel 0
+set_interface_property aso_out readyLatency 0
+set_interface_property aso_out ENABLED true
+set_interface_property aso_out EXPORT_OF ""
+set_interface_property aso_out PORT_NAME_MAP ""
+set_interface_property aso_out CMSIS_SVD_VARIABLES ""
+set_interface_property aso_out SVD_ADDRESS_GROUP ""
+
+add_interface_port aso_out aso_out_data data Output 8
+add_interface_port aso_out aso_out_ready ready Input 1
+add_interface_port aso_out aso_out_valid valid Output 1
+add_interface_port aso_out aso_out_eop endofpacket Output 1
+add_interface_port aso_out aso_out_sop startofpacket Output 1
+
@@ -0,0 +1,76 @@
+###############################################################################
+# timing_report.tcl
+#
+# Reports fmax of every clock of the compiled project and the worst setup
+# paths inside acc_scale.
+#
+# Usage (after compilation of the project):
+#   quartus_sta -t timing_report.tcl          report, compared with baseline
+#   quartus_sta -t timing_report.tcl save     report and save it as baseline
+#
+# Saving the baseline before a change of the hw and running the report after
+# it shows the fmax gained by the change.
+#
+###############################################################################
+
+package require ::quartus::project
+package require ::quartus::sta
+
+set project_name  DMA_Accelerator_Example
+set report_file   timing_report.txt
+set baseline_file timing_baseline.txt
+set save_baseline [expr {[llength $quartus(args)] > 0 && [lindex $quartus(args) 0] == "save"}]
+
+project_open $project_name -revision $project_name
+
+create_timing_netlist
+read_sdc
+# project without sdc file: clocks derived from plls and clock pins
+if {[llength [get_clocks -nowarn *]] == 0} {
+	derive_pll_clocks -create_base_clocks
+}
+derive_clock_uncertainty
+update_timing_netlist
+
+# fmax of every clock, previous values from baseline
+array set baseline {}
+if {[file exists $baseline_file]} {
+	set fh [open $baseline_file r]
+	while {[gets $fh line] >= 0} {
+		if {[llength $line] == 2} {
+			set baseline([lindex $line 0]) [lindex $line 1]
+		}
+	}
+	close $fh
+}
+
+set fh [open $report_file w]
+foreach fmax_info [get_clock_fmax_info] {
+	set clock_name [lindex $fmax_info 0]
+	set fmax [lindex $fmax_info 2]	;# restricted fmax
+	set line [format "%-60s %10.2f MHz" $clock_name $fmax]
+	if {[info exists baseline($clock_name)]} {
+		append line [format "   baseline %10.2f MHz   gain %+8.2f MHz" $baseline($clock_name) [expr {$fmax - $baseline($clock_name)}]]
+	}
+	puts $line
+	puts $fh $line
+	set current($clock_name) $fmax
+}
+close $fh
+
+if {$save_baseline} {
+	set fh [open $baseline_file w]
+	foreach clock_name [array names current] {
+		puts $fh [list $clock_name $current($clock_name)]
+	}
+	close $fh
+	puts "Baseline saved to $baseline_file"
+}
+
+# worst paths with both ends in acc_scale
+report_timing -setup -npaths 10 -detail path_only \
+	-from [get_registers -nowarn *acc_scale*] -to [get_registers -nowarn *acc_scale*] \
+	-panel_name "acc_scale worst setup paths" -file $report_file -append
+
+delete_timing_netlist
+project_close